@@ -0,0 +1,290 @@
+// times every vector operation against the same work done on a raw array,
+// one csv row per (operation, backend, element size, length) on stdout
+#include "vector.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <defer.h>        // personal defer lib
+
+#ifdef VEC_NO_EXPECT
+    #define VARIANT "noexpect"
+#else
+    #define VARIANT "expect"
+#endif
+
+// the arena lib's constructor and destructor, override them if yours are
+// named differently
+#ifndef BENCH_ARENA_NEW
+    #define BENCH_ARENA_NEW(bytes) arena_new(bytes)
+#endif
+#ifndef BENCH_ARENA_FREE
+    #define BENCH_ARENA_FREE(a) arena_free(a)
+#endif
+
+#define REPS        3               // best of, to keep the noise out
+#define MAX_OPS     1000            // cap for the O(n) per op operations
+
+static const u32 sizes[]   = { 4, 8, 16, 64 };
+static const u64 lengths[] = { 1000, 10000, 100000 };
+
+static u32 size;                    // element size of the running sweep
+static volatile u64 sink;           // keeps the results alive
+
+static inline u64 now(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (u64)t.tv_sec * 1000000000ull + (u64)t.tv_nsec;
+}
+
+static inline u64 rng(u64* s){
+    *s ^= *s << 13; *s ^= *s >> 7; *s ^= *s << 17;
+    return *s;
+}
+
+// elements are keyed by their first (up to 8) bytes, the rest is filler
+static inline u64 key(const void* x){
+    u64 k = 0;
+    memcpy(&k, x, size < 8 ? size : 8);
+    return k;
+}
+
+static int cmp(void* a, void* b){
+    const u64 x = key(a), y = key(b);
+    return (x > y) - (x < y);
+}
+
+static int qcmp(const void* a, const void* b){
+    return cmp((void*)a, (void*)b);
+}
+
+static u8 mapped[64];
+static void* mapper(void* x){
+    memcpy(mapped, x, size);
+    mapped[0] ^= 0x5A;
+    return mapped;
+}
+
+static void row(const char* op, const char* backend, u64 length, u64 ops, u64 ns){
+    const double per = (double)ns / (double)ops;
+    printf("%s,%s,%s,%u,%llu,%llu,%.2f,%.0f\n", VARIANT, op, backend, size,
+        (unsigned long long)length, (unsigned long long)ops, per,
+        (double)ops * size * 1e9 / (double)(ns ? ns : 1));
+}
+
+#define TIMED(ns, setup, body)                                              \
+    do{                                                                     \
+        ns = ~0ull;                                                         \
+        for(int r_ = 0; r_ < REPS; r_++){                                   \
+            setup;                                                          \
+            const u64 t_ = now();                                           \
+            body;                                                           \
+            const u64 d_ = now() - t_;                                      \
+            if ( d_ < ns ) ns = d_;                                         \
+        }                                                                   \
+    } while(0)
+
+// the raw baseline: a buffer, a length and a capacity doubled on demand
+typedef struct{ u8* data; u64 size, capacity; } Raw;
+
+static inline void raw_push(Raw* r, const void* x){
+    if ( r -> size == r -> capacity ){
+        r -> capacity = r -> capacity ? r -> capacity * 2 : 10;
+        r -> data = realloc(r -> data, r -> capacity * size);
+    }
+    memcpy(r -> data + r -> size++ * size, x, size);
+}
+
+static void bench_raw(const u8* elems, const u8* sorted, const u64* idx, u64 n){
+    const u64 k = n / 2 < MAX_OPS ? n / 2 : MAX_OPS;
+    u8  x[64];
+    u64 ns;
+    Raw r = { 0 };
+
+    TIMED(ns, free(r.data); r = (Raw){ 0 },
+        for(u64 i = 0; i < n; i++) raw_push(&r, elems + i * size));
+    row("push", "raw", n, n, ns);
+
+    TIMED(ns, ,
+        for(u64 i = 0; i < n; i++){ memcpy(x, r.data + idx[i] * size, size); sink += x[0]; });
+    row("get", "raw", n, n, ns);
+
+    TIMED(ns, ,
+        for(u64 i = 0; i < k; i++){
+            raw_push(&r, x);
+            memmove(r.data + (n / 2 + 1) * size, r.data + n / 2 * size, (r.size - 1 - n / 2) * size);
+            memcpy(r.data + n / 2 * size, elems, size);
+        }
+        r.size -= k);
+    row("insert", "raw", n, k, ns);
+
+    TIMED(ns, memcpy(r.data, elems, n * size); r.size = n,
+        for(u64 i = 0; i < k; i++){
+            memcpy(x, r.data + n / 2 * size, size);
+            memmove(r.data + n / 2 * size, r.data + (n / 2 + 1) * size, (r.size - 1 - n / 2) * size);
+            r.size--;
+        });
+    row("remove", "raw", n, k, ns);
+
+    TIMED(ns, memcpy(r.data, elems, n * size); r.size = n,
+        qsort(r.data, n, size, qcmp));
+    row("sort", "raw", n, n, ns);
+
+    TIMED(ns, memcpy(r.data, elems, n * size),
+        for(u64 i = 0; i < k; i++){
+            const u8* needle = elems + idx[i] * size;
+            u64 j = 0;
+            while ( j < n && cmp(r.data + j * size, (void*)needle) != 0 ) j++;
+            sink += j;
+        });
+    row("search_unsorted", "raw", n, k, ns);
+
+    TIMED(ns, ,
+        for(u64 i = 0; i < k; i++)
+            sink += bsearch(sorted + idx[i] * size, sorted, n, size, qcmp) != NULL);
+    row("search_sorted", "raw", n, k, ns);
+
+    TIMED(ns, ,
+        for(u64 i = 0; i < k; i++){
+            const u8* needle = elems + idx[i] * size;
+            u64 j = 0;
+            while ( j < n && memcmp(r.data + j * size, needle, size) != 0 ) j++;
+            sink += j < n;
+        });
+    row("in", "raw", n, k, ns);
+
+    u8* out = malloc(n * size);
+    TIMED(ns, ,
+        for(u64 i = 0; i < n; i++) memcpy(out + i * size, mapper(r.data + i * size), size));
+    row("map", "raw", n, n, ns);
+
+    Raw j = { 0 };
+    TIMED(ns, free(j.data); j = (Raw){ 0 },
+        j.data = realloc(j.data, n * size); j.capacity = n;
+        memcpy(j.data + j.size * size, r.data, n * size); j.size += n);
+    row("join", "raw", n, n, ns);
+
+    TIMED(ns, ,
+        memcpy(out, r.data, n * size));
+    row("copy", "raw", n, n, ns);
+
+    free(out);
+    free(j.data);
+    free(r.data);
+}
+
+static Vector make(u64 n, Arena a){
+    return a == NULL ? vec_init_(n, size) : vec_arena_(n, size, a);
+}
+
+// an empty vector for the next rep, one that has to grow again like the raw
+// buffer does. vec_fit drops a heap vector back to a single slot, arena
+// vectors never shrink so those get a fresh one out of the sweep's arena
+static Vector fresh(Vector v, Arena a){
+    if ( a != NULL )
+        return make(0, a);
+    vec_clear(v);
+    vec_fit(v);
+    return v;
+}
+
+static void bench_vec(const u8* elems, const u8* sorted, const u64* idx, u64 n, Arena a){
+    const char* backend = a == NULL ? "malloc" : "arena";
+    const u64 k = n / 2 < MAX_OPS ? n / 2 : MAX_OPS;
+    u8  x[64];
+    u64 ns;
+    Vector v = make(0, a);
+
+    TIMED(ns, v = fresh(v, a),
+        for(u64 i = 0; i < n; i++) vec_push(v, (void*)(elems + i * size)));
+    row("push", backend, n, n, ns);
+
+    TIMED(ns, ,
+        for(u64 i = 0; i < n; i++){ vec_get_(v, idx[i], x); sink += x[0]; });
+    row("get", backend, n, n, ns);
+
+    // the previous rep's k inserts are popped untimed, the raw row only pays
+    // for dropping them with r.size -= k
+    TIMED(ns, while ( vec_len(v) > n ) vec_pop_(v, x),
+        for(u64 i = 0; i < k; i++) vec_insert(v, (void*)elems, n / 2));
+    row("insert", backend, n, k, ns);
+
+    TIMED(ns, vec_clear(v); vec_extend_from(v, elems, n),
+        for(u64 i = 0; i < k; i++) vec_remove_(v, n / 2, x));
+    row("remove", backend, n, k, ns);
+
+    Vector s = make(n, a);
+    TIMED(ns, vec_clear(v); vec_extend_from(v, elems, n),
+        vec_sort(v, s, cmp));
+    row("sort", backend, n, n, ns);
+
+    TIMED(ns, ,
+        for(u64 i = 0; i < k; i++){
+            bool flag = UNSORTED;
+            sink += vec_search(v, (void*)(elems + idx[i] * size), &flag, cmp);
+        });
+    row("search_unsorted", backend, n, k, ns);
+
+    TIMED(ns, ,
+        for(u64 i = 0; i < k; i++){
+            bool flag = SORTED;
+            sink += vec_search(s, (void*)(sorted + idx[i] * size), &flag, cmp);
+        });
+    row("search_sorted", backend, n, k, ns);
+
+    TIMED(ns, ,
+        for(u64 i = 0; i < k; i++) sink += vec_in(v, (void*)(elems + idx[i] * size)));
+    row("in", backend, n, k, ns);
+
+    Vector out = make(n, a);
+    TIMED(ns, ,
+        vec_map_(v, out, mapper, size, size));
+    row("map", backend, n, n, ns);
+
+    Vector j = make(0, a);
+    TIMED(ns, j = fresh(j, a),
+        vec_join(j, v));
+    row("join", backend, n, n, ns);
+
+    TIMED(ns, ,
+        vec_copy(v, out));
+    row("copy", backend, n, n, ns);
+}
+
+int main(void){
+    const u64 max_n = lengths[sizeof(lengths) / sizeof(*lengths) - 1];
+    u8*  elems  = malloc(max_n * 64);
+    u8*  sorted = malloc(max_n * 64);
+    u64* idx    = malloc(max_n * sizeof(u64));
+    u64  seed   = 0x9E3779B97F4A7C15ull;
+
+    puts("variant,op,backend,elem_size,length,ops,ns_per_op,bytes_per_s");
+    for(u64 si = 0; si < sizeof(sizes) / sizeof(*sizes); si++){
+        size = sizes[si];
+        for(u64 li = 0; li < sizeof(lengths) / sizeof(*lengths); li++){
+            const u64 n = lengths[li];
+            for(u64 i = 0; i < n * size; i += 8){
+                const u64 r = rng(&seed);
+                memcpy(elems + i, &r, n * size - i < 8 ? n * size - i : 8);
+            }
+            memcpy(sorted, elems, n * size);
+            qsort(sorted, n, size, qcmp);
+            for(u64 i = 0; i < n; i++)
+                idx[i] = rng(&seed) % n;
+
+            bench_raw(elems, sorted, idx, n);
+            bench_vec(elems, sorted, idx, n, NULL);
+            // room for every vector of the sweep, the bump arena never reuses
+            Arena a = BENCH_ARENA_NEW(64 * n * size + (1 << 20));
+            bench_vec(elems, sorted, idx, n, a);
+            BENCH_ARENA_FREE(a);
+            fflush(stdout);
+        }
+    }
+    free(idx);
+    free(sorted);
+    free(elems);
+    cleanup();
+    return 0;
+}
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE                 // mremap
 #include "vector.h"
 
 
@@ -5,11 +6,21 @@
 #include <assert.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stddef.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
 #include <defer.h>        // personal defer lib
 
-//TODO: bench mark with and without __builtin_expect
-
-#ifdef __GNUC__
+// -DVEC_NO_EXPECT drops the branch hints, bench/ builds and times both ways
+#if defined(__GNUC__) && !defined(VEC_NO_EXPECT)
     #define LIKELY(x) __builtin_expect((x), 1)
     #define UNLIKELY(x) __builtin_expect((x), 0)
 #else
@@ -19,22 +30,275 @@
 
 #define handle_err(condition, msg, code)                \
     do{                                                 \
-       if ( LIKELY(condition )){                        \
+       if ( UNLIKELY(condition) ){                      \
             fprintf(stderr, "\e[31m%s\e[m\n", msg);     \
             code;                                       \
         }                                               \
     } while (0);
 
+// instrumentation, -DVEC_STATS counts what every vector does to memory and
+// links them all in a registry, without it every hook compiles to nothing
+#ifdef VEC_STATS
+    #define STAT_ADD(v, field, n)   ((v) -> stats.field += (n))
+    // comparator calls are counted per thread then charged to the vector
+    static _Thread_local u64 cmp_calls;
+    #define CMP(f, a, b)            (cmp_calls++, (f)((a), (b)))
+    #define STAT_CMP_BEGIN()        const u64 cmp_calls_before_ = cmp_calls
+    #define STAT_CMP_END(v)         STAT_ADD(v, cmp_calls, cmp_calls - cmp_calls_before_)
 
-struct vector{
-    u64     capacity    ;
-    u64     size        ;
-    u8*     data        ;
-    Arena   arena       ;
-    u8      block_size  ;
-}; 
+static pthread_mutex_t live_lock = PTHREAD_MUTEX_INITIALIZER;
+static Vector          live_head = NULL;
+
+static void live_link(Vector v){
+    v -> stats = (VecStats){ 0 };
+    pthread_mutex_lock(&live_lock);
+    v -> live_prev = NULL;
+    v -> live_next = live_head;
+    if ( live_head != NULL )
+        live_head -> live_prev = v;
+    live_head = v;
+    pthread_mutex_unlock(&live_lock);
+}
+
+static void live_unlink(Vector v){
+    pthread_mutex_lock(&live_lock);
+    if ( v -> live_prev != NULL )
+        v -> live_prev -> live_next = v -> live_next;
+    else if ( live_head == v )
+        live_head = v -> live_next;
+    else {                                      // already forgotten
+        pthread_mutex_unlock(&live_lock);
+        return;
+    }
+    if ( v -> live_next != NULL )
+        v -> live_next -> live_prev = v -> live_prev;
+    v -> live_prev = v -> live_next = NULL;
+    pthread_mutex_unlock(&live_lock);
+}
+
+static void free_vector(void* p){
+    live_unlink((Vector)p);
+    free(p);
+}
+#else
+    #define STAT_ADD(v, field, n)   ((void)0)
+    #define CMP(f, a, b)            (f)((a), (b))
+    #define STAT_CMP_BEGIN()        ((void)0)
+    #define STAT_CMP_END(v)         ((void)0)
+    #define live_link(v)            ((void)0)
+    #define live_unlink(v)          ((void)0)
+    #define free_vector             free
+#endif
+
+// everything but the buffer itself: default growth, no alignment, heap or arena
+static inline void header_defaults(Vector v, u64 def, u32 block_size){
+    v -> capacity   = def == 0 ? 10 : def;
+    v -> size       = 0;
+    v -> block_size = block_size;
+    v -> align      = 0;
+    v -> growth     = VEC_GROW_DOUBLE;
+    v -> grow_step  = 0;
+    v -> grow       = NULL;
+    v -> reserved   = 0;
+    v -> fd         = -1;
+    v -> readonly   = false;
+    v -> gapped     = false;
+    v -> gap        = VEC_GAP_CLOSED;
+    v -> index      = NULL;
+    v -> inlined    = false;
+    v -> local      = false;
+    live_link(v);
+}
+
+// arena bookkeeping: a bump arena cannot take a block back, so the buffers
+// that vectors outgrow are kept on size class free lists of their arena and
+// handed to the next buffer that needs one. only done for the arenas passed
+// to vec_arena_track, since the lists point into the arena. arena buffers
+// always span at least round16(capacity * block_size + pad) bytes
+#define ARENA_CLASSES   64
+
+typedef struct free_block{
+    struct free_block*  next;
+    u64                 bytes;
+} FreeBlock;
+
+typedef struct arena_book{
+    Arena               arena;
+    struct arena_book*  next;
+    FreeBlock*          free[ARENA_CLASSES];    // blocks of [2^c, 2^(c+1)) bytes
+    VecArenaStats       stats;
+} ArenaBook;
+
+static pthread_mutex_t books_lock = PTHREAD_MUTEX_INITIALIZER;
+static ArenaBook*      books      = NULL;
+
+static inline u64 round16(u64 bytes){
+    return (bytes + 15) & ~(u64)15;
+}
+
+static inline bool books_empty(void){
+    return LIKELY(__atomic_load_n(&books, __ATOMIC_RELAXED) == NULL);
+}
+
+// the callers of the book_* functions hold books_lock
+static ArenaBook* book_of(const Arena a){
+    for(ArenaBook* b = books; b != NULL; b = b -> next)
+        if ( b -> arena == a )
+            return b;
+    return NULL;
+}
+
+static void book_give(ArenaBook* b, u8* p, u64 bytes){
+    b -> stats.live_bytes -= bytes < b -> stats.live_bytes ? bytes : b -> stats.live_bytes;
+    if ( bytes < sizeof(FreeBlock) )
+        return;
+    const u32 c = 63 - __builtin_clzll(bytes);
+    FreeBlock* f = (FreeBlock*)p;
+    f -> next  = b -> free[c];
+    f -> bytes = bytes;
+    b -> free[c] = f;
+    b -> stats.wasted_bytes += bytes;
+}
+
+// any block of the class of *bytes or above fits, the first one found is
+// split and what is left of it goes back on the lists
+static u8* book_take(ArenaBook* b, u64* bytes){
+    const u32 c = *bytes <= 1 ? 0 : 64 - __builtin_clzll(*bytes - 1);
+    for(u32 k = c; k < ARENA_CLASSES; k++){
+        FreeBlock* f = b -> free[k];
+        if ( f == NULL )
+            continue;
+        b -> free[k] = f -> next;
+        const u64 got = f -> bytes;
+        b -> stats.wasted_bytes   -= got;
+        b -> stats.recycled_bytes += *bytes;
+        b -> stats.live_bytes     += got;
+        if ( got - *bytes >= sizeof(FreeBlock) )
+            book_give(b, (u8*)f + *bytes, got - *bytes);
+        else
+            *bytes = got;
+        return (u8*)f;
+    }
+    return NULL;
+}
+
+// end of the latest block every thread carved out of an arena, a buffer
+// ending there is most likely still the latest allocation of its arena
+#define ARENA_RECENT    8
+
+static _Thread_local struct{ Arena arena; u8* end; } recent[ARENA_RECENT];
+
+static inline u32 recent_slot(const Arena a){
+    return (u32)(((uintptr_t)a >> 4) % ARENA_RECENT);
+}
+
+// callers hold books_lock when b is not NULL
+static u8* arena_carve(Arena a, ArenaBook* b, u64 bytes){
+    u8* p = (u8*)alloc_on_arena(a, bytes);
+    if ( p == NULL )
+        return NULL;
+    recent[recent_slot(a)].arena = a;
+    recent[recent_slot(a)].end   = p + bytes;
+    if ( b != NULL )
+        b -> stats.live_bytes += bytes;
+    return p;
+}
+
+// a block of at least *bytes (rounded up to 16) recycled from the free lists
+// of a or else carved out of a, *bytes is set to what it really spans
+static u8* arena_alloc(Arena a, u64* bytes){
+    *bytes = round16(*bytes);
+    if ( books_empty() )
+        return arena_carve(a, NULL, *bytes);
+    pthread_mutex_lock(&books_lock);
+    ArenaBook* b = book_of(a);
+    u8* p = b == NULL ? NULL : book_take(b, bytes);
+    if ( p == NULL )
+        p = arena_carve(a, b, *bytes);
+    pthread_mutex_unlock(&books_lock);
+    return p;
+}
+
+static void arena_release(Arena a, u8* p, u64 bytes){
+    if ( books_empty() || bytes == 0 )
+        return;
+    pthread_mutex_lock(&books_lock);
+    ArenaBook* b = book_of(a);
+    if ( b != NULL )
+        book_give(b, p, bytes);
+    pthread_mutex_unlock(&books_lock);
+}
+
+// carves the bytes right after end out of a and returns end. when something
+// else was allocated there in the meantime the carved bytes are not thrown
+// away, they start a fresh block of total bytes that is returned instead.
+// NULL when neither worked, the pieces then go to the free lists of a
+// tracked arena
+static u8* arena_extend(Arena a, u8* end, u64 bytes, u64 total){
+    const u32 r = recent_slot(a);
+    if ( recent[r].arena != a || recent[r].end != end )
+        return NULL;
+    const bool tracked = !books_empty();
+    if ( tracked )
+        pthread_mutex_lock(&books_lock);
+    ArenaBook* b = tracked ? book_of(a) : NULL;
+    u8* p = arena_carve(a, b, bytes);
+    if ( p != NULL && p != end ){
+        u8* rest = arena_carve(a, b, total - bytes);
+        if ( rest != p + bytes ){
+            if ( b != NULL ){
+                book_give(b, p, bytes);
+                if ( rest != NULL )
+                    book_give(b, rest, total - bytes);
+            }
+            p = NULL;
+        }
+    }
+    else if ( p != NULL && b != NULL )
+        b -> stats.extended ++;
+    if ( tracked )
+        pthread_mutex_unlock(&books_lock);
+    return p;
+}
 
-Vector vec_init_(u64 def, u8 block_size){
+void vec_arena_track(Arena a){
+    pthread_mutex_lock(&books_lock);
+    if ( book_of(a) == NULL ){
+        ArenaBook* b = (ArenaBook*)calloc(1, sizeof(ArenaBook));
+        handle_err(
+            b == NULL,
+            "Error allocating the book of the Arena! aborting now ...",
+            pthread_mutex_unlock(&books_lock);
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        b -> arena = a;
+        b -> next  = books;
+        __atomic_store_n(&books, b, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&books_lock);
+}
+
+void vec_arena_forget(Arena a){
+    pthread_mutex_lock(&books_lock);
+    for(ArenaBook** b = &books; *b != NULL; b = &(*b) -> next)
+        if ( (*b) -> arena == a ){
+            ArenaBook* gone = *b;
+            *b = gone -> next;
+            free(gone);
+            break;
+        }
+    pthread_mutex_unlock(&books_lock);
+}
+
+void vec_arena_stats(const Arena a, VecArenaStats* stats){
+    pthread_mutex_lock(&books_lock);
+    const ArenaBook* b = book_of(a);
+    *stats = b == NULL ? (VecArenaStats){ 0 } : b -> stats;
+    pthread_mutex_unlock(&books_lock);
+}
+
+Vector vec_init_(u64 def, u32 block_size){
     Vector v = (Vector)malloc(sizeof(struct vector));
     handle_err(
         v == NULL,
@@ -42,10 +306,10 @@ Vector vec_init_(u64 def, u8 block_size){
         cleanup();
         exit(EXIT_FAILURE);
     )
-    defer(v, free);
-    v -> capacity = def == 0 ? 10 : def;
-    v -> block_size = block_size;
+    defer(v, free_vector);
+    header_defaults(v, def, block_size);
     v -> data = (u8*)malloc(v -> capacity * block_size);
+    v -> base = v -> data;
     v -> arena = NULL;
     handle_err(
         v -> data == NULL,
@@ -57,7 +321,7 @@ Vector vec_init_(u64 def, u8 block_size){
     return v;
 }
 
-Vector vec_arena_(u64 def, u8 block_size, Arena arena){
+Vector vec_arena_(u64 def, u32 block_size, Arena arena){
     Vector v = (Vector)alloc_on_arena(arena, sizeof(struct vector));
     handle_err(
         v == NULL,
@@ -65,9 +329,10 @@ Vector vec_arena_(u64 def, u8 block_size, Arena arena){
         cleanup();
         exit(EXIT_FAILURE);
     )
-    v -> capacity = def == 0 ? 10 : def;
-    v -> block_size = block_size;
-    v -> data = (u8*)alloc_on_arena(arena, v -> capacity * block_size);
+    header_defaults(v, def, block_size);
+    u64 bytes = v -> capacity * block_size;
+    v -> data = arena_alloc(arena, &bytes);
+    v -> base = v -> data;
     v -> arena = arena;
     handle_err(
         v -> data == NULL,
@@ -75,550 +340,4277 @@ Vector vec_arena_(u64 def, u8 block_size, Arena arena){
         cleanup();
         exit(EXIT_FAILURE);
     )
+    v -> capacity = bytes / block_size;
     return v;
 
 }
-void vec_push(Vector v, void* x){                                                                   //TODO: Realloc for Arena
+
+Vector vec_small_(u64 n, u32 block_size, Arena arena){
+    const u64 capacity = n == 0 ? 10 : n;
+    Vector v = arena == NULL ?
+        (Vector)malloc(VEC_INLINE_OFFSET + capacity * block_size):
+        (Vector)alloc_on_arena(arena, VEC_INLINE_OFFSET + capacity * block_size);
     handle_err(
-            v == NULL || v -> data == NULL,
-            "Null Vector passed as a parameter to push to ...",
-            cleanup();
-            exit(EXIT_FAILURE);
+        v == NULL,
+        "Error Allocating Space for the Vector! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
     )
-    if ( v -> capacity == v -> size ){
-        const u64 old_capa = v -> capacity;
-        v -> capacity *= 2;
-        v -> data = v -> arena == NULL ? (u8*)ds_realloc(v -> data, v -> capacity * v -> block_size ) : realloc_on_arena(v -> arena, v -> data, old_capa * v -> block_size, v -> capacity * v -> block_size);
-        handle_err(
-            v -> data == NULL,
-            "Error resizing the Vector! Watch out the element was NOT pushed ...",
-            cleanup();
-            exit(EXIT_FAILURE);
-        )
-    }
-    memcpy(v -> data + v -> size * v -> block_size, x, v -> block_size);
-    v -> size ++;
+    if ( arena == NULL )
+        defer(v, free_vector);
+    header_defaults(v, capacity, block_size);
+    v -> data = (u8*)v + VEC_INLINE_OFFSET;
+    v -> base = v -> data;
+    v -> arena = arena;
+    v -> inlined = true;
+    return v;
 }
 
-void vec_pop_(Vector v, void* gottem){
+Vector vec_local_(void* mem, u64 header_size, u64 n, u32 block_size, Arena arena){
+    // a caller built without VEC_STATS (or with it, against a library built
+    // without) has a header of another size, the elements would overlap it
     handle_err(
-        v == NULL || v -> data == NULL,
-        "Null Vector passed as a paramater to be popped from ...",
+        header_size != sizeof(struct vector),
+        "Error VEC_LOCAL built with a different struct vector than the library (VEC_STATS)! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
+    Vector v = (Vector)mem;
+    header_defaults(v, n, block_size);
+    // the header goes away with the caller's block, the registry must not see it
+    live_unlink(v);
+    v -> capacity = n;
+    v -> data = (u8*)v + VEC_INLINE_OFFSET;
+    v -> base = v -> data;
+    v -> arena = arena;
+    v -> inlined = true;
+    v -> local = true;
+    return v;
+}
+
+void vec_local_free(Vector v){
     handle_err(
-        v -> size == 0,
-        "Illegal Popping operation on an empty vector ...",
+        !v -> local,
+        "Error vec_local_free only ends VEC_LOCAL vectors! aborting now ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    memcpy(gottem, v -> data + (--v -> size) * v -> block_size, v -> block_size);
+    if ( !v -> inlined ){
+        if ( v -> arena == NULL )
+            free(v -> base);
+        else
+            arena_release(v -> arena, v -> base, round16(v -> capacity * v -> block_size));
+    }
+    v -> data = v -> base = NULL;
+    v -> size = v -> capacity = 0;
+    v -> inlined = true;
 }
 
-void vec_dbg(const Vector v){
-    handle_err(
-        v == NULL,
-        "NULL",
-        return;
-    )
+// the inline storage cannot be resized, the elements are moved to their own
+// buffer the first time the vector outgrows it and it is never used again
+static void spill(Vector v, u64 capa){
+    u64 bytes = capa * v -> block_size;
+    u8* data = v -> arena == NULL ? (u8*)malloc(bytes) : arena_alloc(v -> arena, &bytes);
     handle_err(
-        v -> data == NULL,
-        "(nullvec)",
-        return;
+        data == NULL,
+        "Error resizing the Vector! Watch out the elements were NOT pushed ...",
+        cleanup();
+        exit(EXIT_FAILURE);
     )
-    if ( v -> size == 0 ) {
-        fprintf(stdout, "[]");
-        return;
-    }
-    fprintf(stdout, "[");
-    for ( unsigned i = 0 ; i < v -> size - 1; i ++){
-        for(unsigned j = 0; j < v -> block_size; j++){
-            fprintf(stdout, "%X", v -> data[i * v -> block_size + j]);
-        }
-        fprintf(stdout, ", ");
-    }
-    for(unsigned j = 0; j < v -> block_size; j++){
-        fprintf(stdout, "%X", v -> data[(v -> size - 1) * v -> block_size + j ]);
-    }
-    fprintf(stdout, "]\n");
+    // a local's buffer is freed by vec_local_free, defer would free it twice
+    if ( v -> arena == NULL && !v -> local )
+        defer(data, free);
+    memcpy(data, v -> data, v -> size * v -> block_size);
+    STAT_ADD(v, realloc_bytes, v -> size * v -> block_size);
+    v -> data = data;
+    v -> base = data;
+    v -> capacity = v -> arena == NULL ? capa : bytes / v -> block_size;
+    v -> inlined = false;
 }
 
-void vec_print(const Vector v, void(*printer)(void*)){
+static inline u8* align_up(u8* p, u32 align){
+    return align > 1 ? (u8*)(((uintptr_t)p + align - 1) & ~(uintptr_t)(align - 1)) : p;
+}
+
+// aligned vectors over allocate by align - 1 bytes, base is what the allocator
+// (and defer) know about and data is the first aligned address inside it
+static inline u64 align_pad(const Vector v){
+    return v -> align > 1 ? v -> align - 1 : 0;
+}
+
+Vector vec_aligned_(u64 def, u32 block_size, u32 align, Arena arena){
+    handle_err(
+        align == 0 || (align & (align - 1)) != 0,
+        "Error the alignment of a Vector must be a power of two! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    Vector v = arena == NULL ?
+        (Vector)malloc(sizeof(struct vector)):
+        (Vector)alloc_on_arena(arena, sizeof(struct vector));
     handle_err(
         v == NULL,
-        "NULL",
-        return ;
+        "Error Allocating Space for the Vector! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
     )
+    if ( arena == NULL )
+        defer(v, free_vector);
+    header_defaults(v, def, block_size);
+    v -> align = align;
+    v -> arena = arena;
+    u64 bytes = v -> capacity * block_size + align_pad(v);
+    v -> base = arena == NULL ? (u8*)malloc(bytes) : arena_alloc(arena, &bytes);
     handle_err(
-        v -> data == NULL,
-        "(nullvec)",
-        return ;
+        v -> base == NULL,
+        "Error Allocating Space for the Vector! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
     )
-    if ( v -> size == 0 ) {
-        fprintf(stdout, "[]");
-        return ;
-    }
-    fprintf(stdout, "[");
-    for(unsigned i = 0; i < v -> size - 1; i++){
-        printer(v -> data + i * v -> block_size);
-        fprintf(stdout, ", "); 
+    if ( arena == NULL )
+        defer(v -> base, free);
+    else
+        v -> capacity = (bytes - align_pad(v)) / block_size;
+    v -> data = align_up(v -> base, align);
+    return v;
+}
+
+#ifdef __linux__
+static inline u64 page_round(u64 bytes){
+    const u64 page = (u64)sysconf(_SC_PAGESIZE);
+    return bytes == 0 ? page : (bytes + page - 1) & ~(page - 1);
+}
+
+static void unmap_vector(void* p){
+    Vector v = (Vector)p;
+    live_unlink(v);
+    if ( v -> fd >= 0 ){
+        vec_sync(v);
+        close(v -> fd);
     }
-    printer(v -> data + v -> block_size * ( v -> size - 1 ));
-    fprintf(stdout, "]");
+    munmap(v -> base, v -> reserved);
+    free(v);
 }
+#endif
 
+// first bytes of a file backed vector, padded so that the elements start 64 aligned
+#define VEC_FILE_MAGIC      0x0150414d434556ULL    // "VECMAP\1"
+#define VEC_FILE_VERSION    1
+#define VEC_FILE_HEADER     64
 
-void vec_get_(const Vector v, u64 index, void* gottem){
+typedef struct{
+    u64     magic       ;
+    u32     version     ;
+    u32     block_size  ;
+    u64     size        ;
+    u64     capacity    ;
+} FileHeader;
+
+_Static_assert(sizeof(FileHeader) <= VEC_FILE_HEADER, "the file header outgrew its slot");
+
+Vector vec_mmap_(u64 reserve, u32 block_size){
+#ifdef __linux__
+    Vector v = (Vector)malloc(sizeof(struct vector));
     handle_err(
-            v == NULL || v -> data == NULL,
-            "Null Pointer Error! Illegal access ...",
-            cleanup() ;
-            exit(EXIT_FAILURE);
+        v == NULL,
+        "Error Allocating Space for the Vector! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
     )
+    header_defaults(v, reserve, block_size);
+    // only touched pages are ever backed, the rest is bare address space
+    v -> reserved = page_round(v -> capacity * block_size);
+    v -> base = (u8*)mmap(NULL, v -> reserved, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
     handle_err(
-        index >= v -> size,
-        "Out Of Bounds Error ...",
+        v -> base == MAP_FAILED,
+        "Error Mapping Space for the Vector! Aborting ...",
+        free(v);
         cleanup();
         exit(EXIT_FAILURE);
     )
-    memcpy(gottem, v -> data + v -> block_size * index, v -> block_size);
-}
-
-static inline void inline_vec_push(Vector v, void* x){
-    if ( v -> capacity == v -> size ){
-        const u64 old_capa = v -> capacity;
-        v -> capacity *= 2;
-        v -> data = v -> arena == NULL ? (u8*)ds_realloc(v -> data, v -> capacity * v -> block_size ) : (u8*)realloc_on_arena(v -> arena, v -> data, old_capa * v -> block_size, v -> capacity * v -> block_size);
-        handle_err(
-            v -> data == NULL,
-            "Error resizing the Vector! Watch out the element was NOT pushed ...",
-            cleanup();
-            exit(EXIT_FAILURE);
-        )
-    }
-    memcpy(v -> data + v -> size * v -> block_size, x, v -> block_size);
-    v -> size ++;
+    defer(v, unmap_vector);
+    v -> data = v -> base;
+    v -> arena = NULL;
+    v -> capacity = v -> reserved / block_size;
+    return v;
+#else
+    return vec_init_(reserve, block_size);
+#endif
 }
 
-
-void vec_insert(Vector v, void* x, u64 index){
+Vector vec_open_mapped(const char* path, u32 block_size, u8 mode){
+#ifdef __linux__
     handle_err(
-        v == NULL || v -> data == NULL,
-        "Error inserting into a null vector! aborting now ...",
+        mode > VEC_MAP_RDWR || block_size == 0,
+        "Error invalid mode or block size for a mapped Vector! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
+    const bool readonly = mode == VEC_MAP_RDONLY;
+    const int fd = readonly ? open(path, O_RDONLY | O_CLOEXEC):
+                              open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
     handle_err(
-        index > v -> size,
-        "Error inserting into the vector! index out of bounds, aborting now ...",
+        fd < 0,
+        "Error opening the file backing the Vector! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-
-    if(index == v -> size){
-        inline_vec_push(v, x);
-        return;
-    }
-    if ( v -> capacity == v -> size ){
-        const u64 old_capa = v -> capacity;
-        v -> capacity *= 2;
-        v -> data = v -> arena == NULL ? (u8*)ds_realloc(v -> data, v -> capacity * v -> block_size) : (u8*)realloc_on_arena(v -> arena, v -> data, old_capa * v -> block_size, v -> capacity * v -> block_size);
-        handle_err(
-            v -> data == NULL,
-            "Error resizing the Vector! Watch out the element was NOT pushed ...",
-            cleanup();
-            exit(EXIT_FAILURE);
-        )
-    }
-    memmove(v -> data + v -> block_size * (index+1),
-        v -> data + v -> block_size * index,
-        (v -> size - index) * v -> block_size
-    ); 
-    memcpy(v -> data + v -> block_size * index, x, v -> block_size);
-    v -> size ++; 
+    struct stat st;
+    handle_err(
+        fstat(fd, &st) != 0,
+        "Error reading the file backing the Vector! Aborting ...",
+        close(fd);
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    const bool fresh = st.st_size == 0;
+    handle_err(
+        fresh && readonly,
+        "Error the file backing a read only Vector is empty! Aborting ...",
+        close(fd);
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        !fresh && (u64)st.st_size < VEC_FILE_HEADER,
+        "Error the file backing the Vector is truncated! Aborting ...",
+        close(fd);
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    Vector v = (Vector)malloc(sizeof(struct vector));
+    handle_err(
+        v == NULL,
+        "Error Allocating Space for the Vector! Aborting ...",
+        close(fd);
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    header_defaults(v, 0, block_size);
+    v -> reserved = fresh ?
+        page_round(VEC_FILE_HEADER + v -> capacity * block_size):
+        (u64)st.st_size;
+    handle_err(
+        fresh && ftruncate(fd, (off_t)v -> reserved) != 0,
+        "Error growing the file backing the Vector! Aborting ...",
+        close(fd);
+        free(v);
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    v -> base = (u8*)mmap(NULL, v -> reserved,
+        readonly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    handle_err(
+        v -> base == MAP_FAILED,
+        "Error Mapping the file backing the Vector! Aborting ...",
+        close(fd);
+        free(v);
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    FileHeader* head = (FileHeader*)v -> base;
+    if ( fresh )
+        *head = (FileHeader){ VEC_FILE_MAGIC, VEC_FILE_VERSION, block_size, 0, 0 };
+    handle_err(
+        head -> magic != VEC_FILE_MAGIC || head -> version != VEC_FILE_VERSION ||
+        head -> block_size != block_size ||
+        head -> size > (v -> reserved - VEC_FILE_HEADER) / block_size,
+        "Error the file is not a Vector of this block size! Aborting ...",
+        munmap(v -> base, v -> reserved);
+        close(fd);
+        free(v);
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    v -> fd = fd;
+    v -> readonly = readonly;
+    v -> arena = NULL;
+    v -> data = v -> base + VEC_FILE_HEADER;
+    v -> size = head -> size;
+    v -> capacity = (v -> reserved - VEC_FILE_HEADER) / block_size;
+    if ( !readonly )
+        head -> capacity = v -> capacity;
+    defer(v, unmap_vector);
+    return v;
+#else
+    (void)path; (void)mode;
+    vec_fail_("Error mapped Vectors need linux! Aborting ...");
+#endif
 }
 
-void vec_set(Vector v, void* x, u64 index){
+void vec_sync(Vector v){
+#ifdef __linux__
+    if ( v -> fd < 0 || v -> readonly )
+        return;
+    FileHeader* head = (FileHeader*)v -> base;
+    head -> size = v -> size;
+    head -> capacity = v -> capacity;
     handle_err(
-        v == NULL || v -> data == NULL,
-        "Error inserting into a null vector! aborting now ...",
+        msync(v -> base, page_round(VEC_FILE_HEADER + v -> size * v -> block_size), MS_SYNC) != 0,
+        "Error flushing the Vector to its file! Watch out the file may be stale ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    handle_err(
-        index >= v -> size,
-        "Error setting a case of the vector out of bounds! aborting now ...",
+#else
+    (void)v;
+#endif
+}
+
+Vector vec_gap_(u64 def, u32 block_size, Arena arena){
+    Vector v = arena == NULL ? vec_init_(def, block_size) : vec_arena_(def, block_size, arena);
+    v -> gapped = true;
+    return v;
+}
+
+// the elements before the gap stay where they are, the ones after it are
+// packed against the end of the buffer. a closed gap is the usual layout
+static inline u64 gap_start(const Vector v){
+    return v -> gap < v -> size ? v -> gap : v -> size;
+}
+
+// slides the gap to pos, only the elements between the two positions move
+static void move_gap(Vector v, u64 pos){
+    const u64 from = gap_start(v);
+    const u64 len  = v -> capacity - v -> size;
+    const u32 bs   = v -> block_size;
+    if ( pos < from ){
+        memmove(v -> data + (pos + len) * bs, v -> data + pos * bs, (from - pos) * bs);
+        STAT_ADD(v, moved_bytes, (from - pos) * bs);
+    }
+    else if ( pos > from ){
+        memmove(v -> data + from * bs, v -> data + (from + len) * bs, (pos - from) * bs);
+        STAT_ADD(v, moved_bytes, (pos - from) * bs);
+    }
+    v -> gap = pos;
+}
+
+// readers close the gap as well, a closed one is left untouched so that they
+// never write to a header other threads may be reading
+static inline void close_gap(Vector v){
+    if ( LIKELY(v -> gap == VEC_GAP_CLOSED) )
+        return;
+    if ( v -> gap < v -> size )
+        move_gap(v, v -> size);
+    v -> gap = VEC_GAP_CLOSED;
+}
+
+void vec_close_gap(Vector v){
+    close_gap(v);
+}
+
+static inline VecView as_view(const Vector v){
+    close_gap(v);
+    return (VecView){ v -> data, v -> size, v -> block_size };
+}
+
+static inline void copy_block(u8* dst, const u8* src, const u32 block_size){
+    switch ( block_size ){
+        case 1:  *dst = *src;            return;
+        case 2:  memcpy(dst, src, 2);    return;
+        case 4:  memcpy(dst, src, 4);    return;
+        case 8:  memcpy(dst, src, 8);    return;
+        case 16: memcpy(dst, src, 16);   return;
+        default: memcpy(dst, src, block_size);
+    }
+}
+
+static inline void swap(u8* a, u8* b, const u32 block_size){
+    switch ( block_size ){
+        case 1: { u8  t = *a; *a = *b; *b = t; return; }
+        case 2: { uint16_t x, y; memcpy(&x, a, 2); memcpy(&y, b, 2); memcpy(a, &y, 2); memcpy(b, &x, 2); return; }
+        case 4: { u32 x, y; memcpy(&x, a, 4); memcpy(&y, b, 4); memcpy(a, &y, 4); memcpy(b, &x, 4); return; }
+        case 8: { u64 x, y; memcpy(&x, a, 8); memcpy(&y, b, 8); memcpy(a, &y, 8); memcpy(b, &x, 8); return; }
+        case 16:{ u64 x[2], y[2]; memcpy(x, a, 16); memcpy(y, b, 16); memcpy(a, y, 16); memcpy(b, x, 16); return; }
+    }
+    u64 t;
+    u32 i = 0;
+    for(; i + 8 <= block_size; i += 8){
+        memcpy(&t, a + i, 8); memcpy(a + i, b + i, 8); memcpy(b + i, &t, 8);
+    }
+    for(; i < block_size; i++){
+        const u8 c = a[i]; a[i] = b[i]; b[i] = c;
+    }
+}
+
+// a buffer that is still the latest allocation of its arena grows in place
+// and nothing moves, any other takes a block from the free lists or from the
+// arena. shrinking keeps the buffer whole, its tail would only fragment the
+// free lists
+static void arena_resize(Vector v, u64 capa){
+    const u32 bs   = v -> block_size;
+    const u64 pad  = align_pad(v);
+    const u64 held = round16(v -> capacity * bs + pad);
+    u64 bytes = round16(capa * bs + pad);
+    if ( bytes <= held )
+        return;
+    u8* base = arena_extend(v -> arena, v -> base + held, bytes - held, bytes);
+    if ( base == v -> base + held ){
+        v -> capacity = (bytes - pad) / bs;
+        return;
+    }
+    if ( base == NULL )
+        base = arena_alloc(v -> arena, &bytes);
+    handle_err(
+        base == NULL,
+        "Error resizing the Vector! Watch out the elements were NOT pushed ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    u8* data = align_up(base, v -> align);
+    memcpy(data, v -> data, v -> size * bs);
+    STAT_ADD(v, realloc_bytes, v -> size * bs);
+    arena_release(v -> arena, v -> base, held);
+    v -> base = base;
+    v -> data = data;
+    v -> capacity = (bytes - pad) / bs;
+}
+
+// the only place the element buffer is resized, keeps data aligned for
+// aligned vectors and exits on failure
+static void set_capacity(Vector v, u64 capa){
+    // a zero byte realloc may free the buffer and hand back NULL, which reads
+    // as a failure, and a NULL data reads as a null vector everywhere else
+    if ( UNLIKELY(capa == 0) )
+        capa = 1;
+    close_gap(v);
+#ifdef VEC_STATS
+    if ( capa > v -> capacity )
+        STAT_ADD(v, grows, 1);
+    if ( capa > v -> stats.peak_capacity )
+        v -> stats.peak_capacity = capa;
+#endif
+#ifdef __linux__
+    if ( v -> reserved != 0 ){
+        handle_err(
+            v -> readonly,
+            "Error resizing a read only Vector! aborting now ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        // the kernel moves the page tables, nothing is copied
+        const u64 head  = (u64)(v -> data - v -> base);
+        const u64 bytes = page_round(head + capa * v -> block_size);
+        // a file has to cover the pages before they are mapped, and keep them until unmapped
+        handle_err(
+            v -> fd >= 0 && bytes > v -> reserved && ftruncate(v -> fd, (off_t)bytes) != 0,
+            "Error growing the file backing the Vector! Watch out the elements were NOT pushed ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        u8* base = (u8*)mremap(v -> base, v -> reserved, bytes, MREMAP_MAYMOVE);
+        handle_err(
+            base == MAP_FAILED,
+            "Error remapping the Vector! Watch out the elements were NOT pushed ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        handle_err(
+            v -> fd >= 0 && bytes < v -> reserved && ftruncate(v -> fd, (off_t)bytes) != 0,
+            "Error shrinking the file backing the Vector! aborting now ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        v -> base = base;
+        v -> data = base + head;
+        v -> reserved = bytes;
+        v -> capacity = (bytes - head) / v -> block_size;
+        if ( v -> fd >= 0 )
+            ((FileHeader*)base) -> capacity = v -> capacity;
+        return;
+    }
+#endif
+    if ( UNLIKELY(v -> inlined) ){
+        // shrinking would not give anything back
+        if ( capa > v -> capacity )
+            spill(v, capa);
+        return;
+    }
+    if ( v -> arena != NULL ){
+        arena_resize(v, capa);
+        return;
+    }
+    const u64 pad    = align_pad(v);
+    const u64 offset = (u64)(v -> data - v -> base);
+#ifdef VEC_STATS
+    const uintptr_t old = (uintptr_t)v -> base;
+#endif
+    u8* base = v -> local ?
+        (u8*)realloc(v -> base, capa * v -> block_size + pad):
+        (u8*)ds_realloc(v -> base, capa * v -> block_size + pad);
+    handle_err(
+        base == NULL,
+        "Error resizing the Vector! Watch out the elements were NOT pushed ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+#ifdef VEC_STATS
+    // a moved buffer was copied as a whole by the allocator
+    if ( (uintptr_t)base != old ){
+        const u64 before = v -> capacity, after = capa;
+        STAT_ADD(v, realloc_bytes, (before < after ? before : after) * v -> block_size + pad);
+    }
+#endif
+    u8* data = align_up(base, v -> align);
+    if ( (u64)(data - base) != offset ){
+        memmove(data, base + offset, (v -> size < capa ? v -> size : capa) * v -> block_size);
+        STAT_ADD(v, realloc_bytes, (v -> size < capa ? v -> size : capa) * v -> block_size);
+    }
+    v -> base = base;
+    v -> data = data;
+    v -> capacity = capa;
+}
+
+static inline u64 next_capacity(const Vector v, u64 needed){
+    u64 capa;
+    switch ( v -> growth ){
+        case VEC_GROW_HALF:   capa = v -> capacity + v -> capacity / 2;     break;
+        case VEC_GROW_LINEAR: capa = v -> capacity + v -> grow_step;        break;
+        case VEC_GROW_CUSTOM: capa = v -> grow(v -> capacity, needed);      break;
+        default:              capa = v -> capacity * 2;
+    }
+    return capa < needed ? needed : capa;
+}
+
+// read only mappings fault on the first write, the vectors are checked up
+// front by everything that changes them
+static inline void check_writable(const Vector v){
+    handle_err(
+        v -> readonly,
+        "Error writing to a read only Vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+}
+
+// grows the buffer once so that it can hold at least `needed` elements,
+// following the growth policy when that is enough to avoid paying for a
+// realloc per range call
+static inline void reserve_for(Vector v, u64 needed){
+    check_writable(v);
+    close_gap(v);
+    if ( LIKELY(needed <= v -> capacity) )
+        return;
+    set_capacity(v, next_capacity(v, needed));
+}
+
+// hash index (vec_attach_hash_index): robin hood open addressing over the
+// distinct elements. an entry only holds the position of one copy of its
+// element, keys are compared in place through the vector and never copied,
+// and it counts the copies so that vec_count is a lookup as well
+typedef struct{
+    u64 hash;                   // top bit always set, 0 marks an empty slot
+    u64 pos;
+    u64 count;
+} IndexEntry;
+
+struct vec_hash_index{
+    u64         (*hash)(const void* x, u32 size);
+    IndexEntry* slots;
+    u64         mask;
+    u64         used;
+    bool        stale;          // a bulk operation is rewriting the elements, the hooks stand down
+};
+
+#define INDEX_MIN_SLOTS 16
+
+static u64 default_hash(const void* x, u32 size){
+    const u8* p = (const u8*)x;
+    u64 h = 0x9e3779b97f4a7c15ull ^ size, w;
+    u32 i = 0;
+    for(; i + 8 <= size; i += 8){
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 31;
+    }
+    if ( i < size ){
+        w = 0;
+        memcpy(&w, p + i, size - i);
+        h = (h ^ w) * 0xbf58476d1ce4e5b9ull;
+    }
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27; h *= 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+static inline u8* element_at(const Vector v, u64 i){
+    return v -> data + vec_slot_(v, i) * v -> block_size;
+}
+
+static inline u64 index_hash(const Vector v, const void* x){
+    return v -> index -> hash(x, v -> block_size) | (1ull << 63);
+}
+
+// the slots come from the arena of the vector when it has one, the old ones
+// then go back to its free lists
+static IndexEntry* index_slots(const Vector v, IndexEntry* old, u64 n){
+    u64 bytes = n * sizeof(IndexEntry);
+    IndexEntry* slots = v -> arena != NULL ?
+        (IndexEntry*)arena_alloc(v -> arena, &bytes):
+        old == NULL ?
+        (IndexEntry*)malloc(n * sizeof(IndexEntry)):
+        (IndexEntry*)ds_realloc(old, n * sizeof(IndexEntry));
+    handle_err(
+        slots == NULL,
+        "Error allocating the hash index of the Vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    if ( v -> arena == NULL && old == NULL )
+        defer(slots, free);
+    memset(slots, 0, n * sizeof(IndexEntry));
+    return slots;
+}
+
+// entries sitting further from their home slot than the one being placed
+// keep their place, the others are pushed along (robin hood)
+static void index_place(struct vec_hash_index* ix, IndexEntry e){
+    u64 s = e.hash & ix -> mask;
+    for(u64 d = 0;; d++, s = (s + 1) & ix -> mask){
+        IndexEntry* cur = ix -> slots + s;
+        if ( cur -> hash == 0 ){
+            *cur = e;
+            ix -> used ++;
+            return;
+        }
+        const u64 cd = (s - cur -> hash) & ix -> mask;
+        if ( cd < d ){
+            const IndexEntry t = *cur;
+            *cur = e;
+            e = t;
+            d = cd;
+        }
+    }
+}
+
+static void index_resize(Vector v, u64 n){
+    struct vec_hash_index* ix = v -> index;
+    const u64 old_n = ix -> slots == NULL ? 0 : ix -> mask + 1;
+    IndexEntry* keep = ix -> slots;
+    if ( v -> arena == NULL && ix -> used != 0 ){
+        keep = (IndexEntry*)malloc(old_n * sizeof(IndexEntry));
+        handle_err(
+            keep == NULL,
+            "Error growing the hash index of the Vector! aborting now ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        memcpy(keep, ix -> slots, old_n * sizeof(IndexEntry));
+    }
+    ix -> slots = index_slots(v, ix -> slots, n);
+    ix -> mask  = n - 1;
+    ix -> used  = 0;
+    if ( keep == NULL || keep == ix -> slots )
+        return;
+    for(u64 i = 0; i < old_n; i++)
+        if ( keep[i].hash != 0 )
+            index_place(ix, keep[i]);
+    if ( v -> arena == NULL )
+        free(keep);
+    else
+        arena_release(v -> arena, (u8*)keep, old_n * sizeof(IndexEntry));
+}
+
+// the entry holding x, NULL when the vector has no copy of it
+static IndexEntry* index_find(const Vector v, const void* x, const u64 h){
+    const struct vec_hash_index* ix = v -> index;
+    u64 s = h & ix -> mask;
+    for(u64 d = 0;; d++, s = (s + 1) & ix -> mask){
+        IndexEntry* e = ix -> slots + s;
+        if ( e -> hash == 0 || ((s - e -> hash) & ix -> mask) < d )
+            return NULL;
+        if ( e -> hash == h && memcmp(element_at(v, e -> pos), x, v -> block_size) == 0 )
+            return e;
+    }
+}
+
+// backward shift deletion, the entries after the hole move one slot closer home
+static void index_erase(struct vec_hash_index* ix, IndexEntry* e){
+    u64 s = (u64)(e - ix -> slots);
+    for(;;){
+        const u64 n = (s + 1) & ix -> mask;
+        const IndexEntry* next = ix -> slots + n;
+        if ( next -> hash == 0 || ((n - next -> hash) & ix -> mask) == 0 )
+            break;
+        ix -> slots[s] = *next;
+        s = n;
+    }
+    ix -> slots[s] = (IndexEntry){ 0 };
+    ix -> used --;
+}
+
+static inline bool index_live(const Vector v){
+    return UNLIKELY(v -> index != NULL) && !v -> index -> stale;
+}
+
+// the element at i was just written
+static void index_add(Vector v, u64 i){
+    if ( LIKELY(!index_live(v)) )
+        return;
+    struct vec_hash_index* ix = v -> index;
+    const u8* x  = element_at(v, i);
+    const u64 h  = index_hash(v, x);
+    IndexEntry* e = index_find(v, x, h);
+    if ( e != NULL ){
+        e -> count ++;
+        return;
+    }
+    if ( (ix -> used + 1) * 8 > (ix -> mask + 1) * 7 )
+        index_resize(v, (ix -> mask + 1) * 2);
+    index_place(ix, (IndexEntry){ h, i, 1 });
+}
+
+// the element at i is about to be overwritten or removed. when the entry
+// pointed at that very copy another one is looked for, which is the only
+// lookup of the index that scans
+static void index_drop(Vector v, u64 i){
+    if ( LIKELY(!index_live(v)) )
+        return;
+    const u8* x  = element_at(v, i);
+    IndexEntry* e = index_find(v, x, index_hash(v, x));
+    if ( e == NULL )
+        return;
+    if ( -- e -> count == 0 ){
+        index_erase(v -> index, e);
+        return;
+    }
+    if ( e -> pos != i )
+        return;
+    for(u64 j = 0; j < v -> size; j++)
+        if ( j != i && memcmp(element_at(v, j), x, v -> block_size) == 0 ){
+            e -> pos = j;
+            return;
+        }
+}
+
+// positions from `from` on moved by delta (insert / remove in the middle)
+static void index_shift(Vector v, u64 from, i64 delta){
+    if ( LIKELY(!index_live(v)) )
+        return;
+    const struct vec_hash_index* ix = v -> index;
+    for(u64 s = 0; s <= ix -> mask; s++)
+        if ( ix -> slots[s].hash != 0 && ix -> slots[s].pos >= from )
+            ix -> slots[s].pos += (u64)delta;
+}
+
+static inline void index_stale(Vector v){
+    if ( UNLIKELY(v -> index != NULL) )
+        v -> index -> stale = true;
+}
+
+static void index_rebuild(Vector v){
+    struct vec_hash_index* ix = v -> index;
+    memset(ix -> slots, 0, (ix -> mask + 1) * sizeof(IndexEntry));
+    ix -> used  = 0;
+    ix -> stale = false;
+    for(u64 i = 0; i < v -> size; i++)
+        index_add(v, i);
+}
+
+// bulk operations mark the index stale while they rewrite the elements and
+// settle it before they return, so lookups only ever read the table and
+// concurrent ones stay as safe as they are without an index
+static inline void index_settle(Vector v){
+    if ( UNLIKELY(v -> index != NULL) && v -> index -> stale )
+        index_rebuild(v);
+}
+
+// for the operations that are done rewriting by the time they get to it
+static inline void index_refresh(Vector v){
+    index_stale(v);
+    index_settle(v);
+}
+
+void vec_index_rebuild_(Vector v){
+    index_refresh(v);
+}
+
+void vec_attach_hash_index(Vector v, u64 (*hash)(const void* x, u32 size)){
+    handle_err(
+        v -> data == NULL,
+        "Error attaching a hash index to a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    if ( v -> index == NULL ){
+        struct vec_hash_index* ix = v -> arena != NULL ?
+            (struct vec_hash_index*)alloc_on_arena(v -> arena, sizeof(struct vec_hash_index)):
+            (struct vec_hash_index*)malloc(sizeof(struct vec_hash_index));
+        handle_err(
+            ix == NULL,
+            "Error allocating the hash index of the Vector! aborting now ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        if ( v -> arena == NULL )
+            defer(ix, free);
+        *ix = (struct vec_hash_index){ .slots = NULL, .mask = 0, .used = 0 };
+        v -> index = ix;
+        u64 n = INDEX_MIN_SLOTS;
+        while ( n * 7 < v -> size * 8 )
+            n *= 2;
+        index_resize(v, n);
+    }
+    v -> index -> hash = hash == NULL ? default_hash : hash;
+    index_rebuild(v);
+}
+
+static IndexEntry* index_lookup(const Vector v, const void* x){
+    return index_find(v, x, index_hash(v, x));
+}
+
+u64 vec_hash_find(const Vector v, void* x){
+    handle_err(
+        v -> data == NULL || v -> index == NULL,
+        "Error in hash find method ! the vector has no hash index, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    // only a vector being rewritten right now has a stale index
+    if ( UNLIKELY(!index_live(v)) ){
+        u64 i = 0;
+        while ( i < v -> size && memcmp(element_at(v, i), x, v -> block_size) != 0 )
+            i++;
+        return i;
+    }
+    const IndexEntry* e = index_lookup(v, x);
+    return e == NULL ? v -> size : e -> pos;
+}
+
+void vec_push(Vector v, void* x){
+    handle_err(
+            v == NULL || v -> data == NULL,
+            "Null Vector passed as a parameter to push to ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+    )
+    check_writable(v);
+    close_gap(v);
+    if ( v -> capacity == v -> size )
+        reserve_for(v, v -> size + 1);
+    memcpy(v -> data + v -> size * v -> block_size, x, v -> block_size);
+    v -> size ++;
+    index_add(v, v -> size - 1);
+}
+
+void vec_pop_(Vector v, void* gottem){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Null Vector passed as a paramater to be popped from ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(v);
+    handle_err(
+        v -> size == 0,
+        "Illegal Popping operation on an empty vector ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(v);
+    index_drop(v, v -> size - 1);
+    memcpy(gottem, v -> data + (--v -> size) * v -> block_size, v -> block_size);
+}
+
+void vec_dbg(const Vector v){
+    handle_err(
+        v == NULL,
+        "NULL",
+        return;
+    )
+    handle_err(
+        v -> data == NULL,
+        "(nullvec)",
+        return;
+    )
+    if ( v -> size == 0 ) {
+        fprintf(stdout, "[]");
+        return;
+    }
+    close_gap(v);
+    fprintf(stdout, "[");
+    for ( unsigned i = 0 ; i < v -> size - 1; i ++){
+        for(unsigned j = 0; j < v -> block_size; j++){
+            fprintf(stdout, "%X", v -> data[i * v -> block_size + j]);
+        }
+        fprintf(stdout, ", ");
+    }
+    for(unsigned j = 0; j < v -> block_size; j++){
+        fprintf(stdout, "%X", v -> data[(v -> size - 1) * v -> block_size + j ]);
+    }
+    fprintf(stdout, "]\n");
+}
+
+static void print_view(const VecView v, void(*printer)(void*)){
+    if ( v.size == 0 ) {
+        fprintf(stdout, "[]");
+        return ;
+    }
+    fprintf(stdout, "[");
+    for(u64 i = 0; i < v.size - 1; i++){
+        printer((void*)(v.data + i * v.block_size));
+        fprintf(stdout, ", "); 
+    }
+    printer((void*)(v.data + v.block_size * ( v.size - 1 )));
+    fprintf(stdout, "]");
+}
+
+void vec_print(const Vector v, void(*printer)(void*)){
+    handle_err(
+        v == NULL,
+        "NULL",
+        return ;
+    )
+    handle_err(
+        v -> data == NULL,
+        "(nullvec)",
+        return ;
+    )
+    print_view(as_view(v), printer);
+}
+
+
+void vec_get_(const Vector v, u64 index, void* gottem){
+    handle_err(
+            v == NULL || v -> data == NULL,
+            "Null Pointer Error! Illegal access ...",
+            cleanup() ;
+            exit(EXIT_FAILURE);
+    )
+    handle_err(
+        index >= v -> size,
+        "Out Of Bounds Error ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    memcpy(gottem, v -> data + v -> block_size * vec_slot_(v, index), v -> block_size);
+}
+
+static inline void inline_vec_push(Vector v, void* x){
+    close_gap(v);
+    if ( v -> capacity == v -> size )
+        reserve_for(v, v -> size + 1);
+    memcpy(v -> data + v -> size * v -> block_size, x, v -> block_size);
+    v -> size ++;
+    index_add(v, v -> size - 1);
+}
+
+
+void vec_insert(Vector v, void* x, u64 index){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error inserting into a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(v);
+    handle_err(
+        index > v -> size,
+        "Error inserting into the vector! index out of bounds, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+
+    index_shift(v, index, 1);
+    if ( v -> gapped ){
+        // a full buffer regrows with the gap closed, at the end
+        if ( v -> capacity == v -> size )
+            reserve_for(v, v -> size + 1);
+        move_gap(v, index);
+        memcpy(v -> data + index * v -> block_size, x, v -> block_size);
+        v -> gap = index + 1;
+        v -> size ++;
+        index_add(v, index);
+        return;
+    }
+    if(index == v -> size){
+        inline_vec_push(v, x);
+        return;
+    }
+    if ( v -> capacity == v -> size )
+        reserve_for(v, v -> size + 1);
+    memmove(v -> data + v -> block_size * (index+1),
+        v -> data + v -> block_size * index,
+        (v -> size - index) * v -> block_size
+    ); 
+    STAT_ADD(v, moved_bytes, (v -> size - index) * v -> block_size);
+    memcpy(v -> data + v -> block_size * index, x, v -> block_size);
+    v -> size ++; 
+    index_add(v, index);
+}
+
+void vec_set(Vector v, void* x, u64 index){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error inserting into a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(v);
+    handle_err(
+        index >= v -> size,
+        "Error setting a case of the vector out of bounds! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    index_drop(v, index);
+    memcpy(v -> data + v -> block_size * vec_slot_(v, index), x, v -> block_size);
+    index_add(v, index);
+}
+
+void vec_remove_(Vector v, u64 index, void* gottem){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error removing into a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(v);
+    handle_err(
+        index >= v -> size,
+        "Error removing into the vector! index out of bounds, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    index_drop(v, index);
+    if ( v -> gapped ){
+        // the element right after the gap is swallowed by it
+        move_gap(v, index);
+        memcpy(gottem, v -> data + (index + v -> capacity - v -> size) * v -> block_size, v -> block_size);
+        v -> size --;
+        index_shift(v, index + 1, -1);
+        return;
+    }
+    memcpy(
+        gottem,
+        v -> data + v -> block_size * index,
+        v -> block_size
+    );
+    memmove(
+       v -> data + index * v -> block_size,
+       v -> data + (index + 1) * v -> block_size,
+       v -> block_size * (v -> size - index - 1)
+    );
+    STAT_ADD(v, moved_bytes, v -> block_size * (v -> size - index - 1));
+    v -> size --;
+    index_shift(v, index + 1, -1);
+   
+}
+
+bool vec_empty(const Vector v){ return v -> size == 0; }
+
+u64  vec_len(const Vector v) { return v -> size; }
+
+void vec_reverse(Vector src, Vector dest){
+    handle_err(
+        src == NULL || dest == NULL || src -> data == NULL || dest -> data == NULL,
+        "Error in reverse method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        src -> block_size != dest -> block_size,
+        "unresolvable difference in datatypes of source and destination of reverse ! aboring ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+   
+    check_writable(dest);
+    close_gap(src);
+    index_stale(dest);
+    const u64 orig_size = src -> size;
+    const u32 bs = src -> block_size;
+
+    if ( src == dest ){
+        for(u64 i = 0; i < orig_size / 2; i++)
+            swap(src -> data + i * bs, src -> data + (orig_size - 1 - i) * bs, bs);
+        index_settle(dest);
+        return;
+    }
+    reserve_for(dest, orig_size);
+    for(u64 i = 0; i < orig_size; i++)
+        copy_block(dest -> data + (orig_size - 1 - i) * bs, src -> data + i * bs, bs);
+    dest -> size = orig_size;
+    index_settle(dest);
+}
+
+void vec_join(Vector appendee, const Vector appended){
+     handle_err(
+        appendee == NULL || appended == NULL || appendee -> data == NULL || appended -> data == NULL,
+        "Error in joining method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        appendee -> block_size != appended -> block_size,
+        "unresolvable difference in datatypes of source and destination of join ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(appendee);
+    close_gap(appendee);
+    close_gap(appended);
+    u64 capacity_cap = appendee -> size + appended -> size;
+    if ( appendee -> capacity < capacity_cap )
+        set_capacity(appendee, capacity_cap);
+    memcpy(appendee -> data + appendee -> size * appendee -> block_size,
+        appended -> data,
+        appended -> size * appendee -> block_size
+    );
+    const u64 from = appendee -> size;
+    appendee -> size = capacity_cap;
+    for(u64 i = from; i < capacity_cap; i++)
+        index_add(appendee, i);
+}
+
+// membership scans: the needle is broadcast and compared against a whole
+// register of elements at a time, the widest kernels the cpu supports are
+// picked once at startup (scalar ones elsewhere)
+
+#define DEFINE_SCAN_KERNELS(isa, w, attrs, STEP, DIV, BROADCAST, MATCH)                 \
+    static attrs u64 find_##isa##_##w(const u8* data, u64 n, const u8* x, u64 from){    \
+        BROADCAST;                                                                      \
+        u64 i = from;                                                                   \
+        for(; i + STEP / w <= n; i += STEP / w){                                        \
+            const u64 m = MATCH(data + i * w);                                          \
+            if ( m )                                                                    \
+                return i + __builtin_ctzll(m) / DIV;                                    \
+        }                                                                               \
+        for(; i < n; i++)                                                               \
+            if ( memcmp(data + i * w, x, w) == 0 )                                      \
+                return i;                                                               \
+        return n;                                                                       \
+    }                                                                                   \
+    static attrs u64 count_##isa##_##w(const u8* data, u64 n, const u8* x){             \
+        BROADCAST;                                                                      \
+        u64 i = 0, bits = 0, c = 0;                                                     \
+        for(; i + STEP / w <= n; i += STEP / w)                                         \
+            bits += __builtin_popcountll(MATCH(data + i * w));                          \
+        for(c = bits / DIV; i < n; i++)                                                 \
+            c += memcmp(data + i * w, x, w) == 0;                                       \
+        return c;                                                                       \
+    }
+
+#define SCALAR_BROADCAST(T)     T nv; memcpy(&nv, x, sizeof(T))
+#define SCALAR_MATCH(T, p)      ({ T e; memcpy(&e, (p), sizeof(T)); (u64)(e == nv); })
+#define SCALAR_MATCH_U8(p)      SCALAR_MATCH(u8, p)
+#define SCALAR_MATCH_U16(p)     SCALAR_MATCH(uint16_t, p)
+#define SCALAR_MATCH_U32(p)     SCALAR_MATCH(u32, p)
+#define SCALAR_MATCH_U64(p)     SCALAR_MATCH(u64, p)
+
+DEFINE_SCAN_KERNELS(scalar, 1, , 1, 1, SCALAR_BROADCAST(u8),       SCALAR_MATCH_U8)
+DEFINE_SCAN_KERNELS(scalar, 2, , 2, 1, SCALAR_BROADCAST(uint16_t), SCALAR_MATCH_U16)
+DEFINE_SCAN_KERNELS(scalar, 4, , 4, 1, SCALAR_BROADCAST(u32),      SCALAR_MATCH_U32)
+DEFINE_SCAN_KERNELS(scalar, 8, , 8, 1, SCALAR_BROADCAST(u64),      SCALAR_MATCH_U64)
+
+static bool equal_scalar(const u8* a, const u8* b, u64 bytes){
+    return memcmp(a, b, bytes) == 0;
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+
+#define SSE2_LOAD(p)            _mm_loadu_si128((const __m128i*)(p))
+#define SSE2_MATCH_1(p)         (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(SSE2_LOAD(p), nv))
+#define SSE2_MATCH_2(p)         (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi16(SSE2_LOAD(p), nv))
+#define SSE2_MATCH_4(p)         (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi32(SSE2_LOAD(p), nv))
+// no 64 bit compare before sse4.1, both 32 bit halves have to match
+#define SSE2_MATCH_8(p)         ({ const __m128i c = _mm_cmpeq_epi32(SSE2_LOAD(p), nv);      \
+                                   (u64)(u32)_mm_movemask_epi8(                            \
+                                       _mm_and_si128(c, _mm_shuffle_epi32(c, 0xB1))); })
+
+DEFINE_SCAN_KERNELS(sse2, 1, , 16, 1, __m128i nv = _mm_set1_epi8(*(const char*)x),                                 SSE2_MATCH_1)
+DEFINE_SCAN_KERNELS(sse2, 2, , 16, 2, int16_t v_; memcpy(&v_, x, 2); __m128i nv = _mm_set1_epi16(v_),              SSE2_MATCH_2)
+DEFINE_SCAN_KERNELS(sse2, 4, , 16, 4, int32_t v_; memcpy(&v_, x, 4); __m128i nv = _mm_set1_epi32(v_),              SSE2_MATCH_4)
+DEFINE_SCAN_KERNELS(sse2, 8, , 16, 8, long long v_; memcpy(&v_, x, 8); __m128i nv = _mm_set1_epi64x(v_),           SSE2_MATCH_8)
+
+#define AVX2_ATTR               __attribute__((target("avx2")))
+#define AVX2_LOAD(p)            _mm256_loadu_si256((const __m256i*)(p))
+#define AVX2_MATCH_1(p)         (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(AVX2_LOAD(p), nv))
+#define AVX2_MATCH_2(p)         (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi16(AVX2_LOAD(p), nv))
+#define AVX2_MATCH_4(p)         (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi32(AVX2_LOAD(p), nv))
+#define AVX2_MATCH_8(p)         (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi64(AVX2_LOAD(p), nv))
+
+DEFINE_SCAN_KERNELS(avx2, 1, AVX2_ATTR, 32, 1, __m256i nv = _mm256_set1_epi8(*(const char*)x),                     AVX2_MATCH_1)
+DEFINE_SCAN_KERNELS(avx2, 2, AVX2_ATTR, 32, 2, int16_t v_; memcpy(&v_, x, 2); __m256i nv = _mm256_set1_epi16(v_),  AVX2_MATCH_2)
+DEFINE_SCAN_KERNELS(avx2, 4, AVX2_ATTR, 32, 4, int32_t v_; memcpy(&v_, x, 4); __m256i nv = _mm256_set1_epi32(v_),  AVX2_MATCH_4)
+DEFINE_SCAN_KERNELS(avx2, 8, AVX2_ATTR, 32, 8, long long v_; memcpy(&v_, x, 8); __m256i nv = _mm256_set1_epi64x(v_), AVX2_MATCH_8)
+
+// avx-512 compares straight into a mask register, one bit per element
+#define AVX512_ATTR             __attribute__((target("avx512f,avx512bw")))
+#define AVX512_LOAD(p)          _mm512_loadu_si512((const void*)(p))
+#define AVX512_MATCH_1(p)       (u64)_mm512_cmpeq_epi8_mask(AVX512_LOAD(p), nv)
+#define AVX512_MATCH_2(p)       (u64)_mm512_cmpeq_epi16_mask(AVX512_LOAD(p), nv)
+#define AVX512_MATCH_4(p)       (u64)_mm512_cmpeq_epi32_mask(AVX512_LOAD(p), nv)
+#define AVX512_MATCH_8(p)       (u64)_mm512_cmpeq_epi64_mask(AVX512_LOAD(p), nv)
+
+DEFINE_SCAN_KERNELS(avx512, 1, AVX512_ATTR, 64, 1, __m512i nv = _mm512_set1_epi8(*(const char*)x),                     AVX512_MATCH_1)
+DEFINE_SCAN_KERNELS(avx512, 2, AVX512_ATTR, 64, 1, int16_t v_; memcpy(&v_, x, 2); __m512i nv = _mm512_set1_epi16(v_),  AVX512_MATCH_2)
+DEFINE_SCAN_KERNELS(avx512, 4, AVX512_ATTR, 64, 1, int32_t v_; memcpy(&v_, x, 4); __m512i nv = _mm512_set1_epi32(v_),  AVX512_MATCH_4)
+DEFINE_SCAN_KERNELS(avx512, 8, AVX512_ATTR, 64, 1, long long v_; memcpy(&v_, x, 8); __m512i nv = _mm512_set1_epi64(v_), AVX512_MATCH_8)
+
+static bool equal_sse2(const u8* a, const u8* b, u64 bytes){
+    u64 i = 0;
+    for(; i + 16 <= bytes; i += 16)
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi8(SSE2_LOAD(a + i), SSE2_LOAD(b + i))) != 0xFFFF )
+            return false;
+    return memcmp(a + i, b + i, bytes - i) == 0;
+}
+
+AVX2_ATTR static bool equal_avx2(const u8* a, const u8* b, u64 bytes){
+    u64 i = 0;
+    for(; i + 32 <= bytes; i += 32)
+        if ( (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(AVX2_LOAD(a + i), AVX2_LOAD(b + i))) != 0xFFFFFFFFu )
+            return false;
+    return memcmp(a + i, b + i, bytes - i) == 0;
+}
+
+AVX512_ATTR static bool equal_avx512(const u8* a, const u8* b, u64 bytes){
+    u64 i = 0;
+    for(; i + 64 <= bytes; i += 64)
+        if ( _mm512_cmpneq_epi64_mask(AVX512_LOAD(a + i), AVX512_LOAD(b + i)) )
+            return false;
+    return memcmp(a + i, b + i, bytes - i) == 0;
+}
+#endif
+
+// kernels are indexed by log2(block_size) for 1, 2, 4 and 8 byte elements
+static struct{
+    u64  (*find[4])(const u8*, u64, const u8*, u64);
+    u64  (*count[4])(const u8*, u64, const u8*);
+    bool (*equal)(const u8*, const u8*, u64);
+} scan = {
+    { find_scalar_1, find_scalar_2, find_scalar_4, find_scalar_8 },
+    { count_scalar_1, count_scalar_2, count_scalar_4, count_scalar_8 },
+    equal_scalar
+};
+
+__attribute__((constructor)) static void scan_dispatch(void){
+#if defined(__x86_64__) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") ){
+        scan.find[0]  = find_avx512_1;  scan.find[1]  = find_avx512_2;
+        scan.find[2]  = find_avx512_4;  scan.find[3]  = find_avx512_8;
+        scan.count[0] = count_avx512_1; scan.count[1] = count_avx512_2;
+        scan.count[2] = count_avx512_4; scan.count[3] = count_avx512_8;
+        scan.equal    = equal_avx512;
+    }
+    else if ( __builtin_cpu_supports("avx2") ){
+        scan.find[0]  = find_avx2_1;  scan.find[1]  = find_avx2_2;
+        scan.find[2]  = find_avx2_4;  scan.find[3]  = find_avx2_8;
+        scan.count[0] = count_avx2_1; scan.count[1] = count_avx2_2;
+        scan.count[2] = count_avx2_4; scan.count[3] = count_avx2_8;
+        scan.equal    = equal_avx2;
+    }
+    else {
+        scan.find[0]  = find_sse2_1;  scan.find[1]  = find_sse2_2;
+        scan.find[2]  = find_sse2_4;  scan.find[3]  = find_sse2_8;
+        scan.count[0] = count_sse2_1; scan.count[1] = count_sse2_2;
+        scan.count[2] = count_sse2_4; scan.count[3] = count_sse2_8;
+        scan.equal    = equal_sse2;
+    }
+#endif
+}
+
+// -1 for block sizes without a dedicated kernel
+static inline int scan_kernel(const u32 block_size){
+    switch ( block_size ){
+        case 1: return 0;
+        case 2: return 1;
+        case 4: return 2;
+        case 8: return 3;
+        default: return -1;
+    }
+}
+
+// index of the first element equal to x at or after from, v.size if none
+static inline u64 scan_find(const VecView v, const void* x, u64 from){
+    const int k = scan_kernel(v.block_size);
+    if ( LIKELY(k >= 0) )
+        return scan.find[k](v.data, v.size, (const u8*)x, from);
+    for(u64 i = from; i < v.size; i++)
+        if ( memcmp(v.data + i * v.block_size, x, v.block_size) == 0 )
+            return i;
+    return v.size;
+}
+
+static inline u64 scan_count(const VecView v, const void* x){
+    const int k = scan_kernel(v.block_size);
+    if ( LIKELY(k >= 0) )
+        return scan.count[k](v.data, v.size, (const u8*)x);
+    u64 occurences = 0;
+    for(u64 i = 0; i < v.size; i++)
+        if ( memcmp( v.data + i * v.block_size, x, v.block_size ) == 0 )
+            occurences ++;
+    return occurences;
+}
+
+static inline bool view_equal(const VecView a, const VecView b){
+    return a.size == b.size && scan.equal(a.data, b.data, a.size * a.block_size);
+}
+
+bool vec_in(const Vector v, void* x){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error searching in a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    if ( index_live(v) )
+        return index_lookup(v, x) != NULL;
+    return scan_find(as_view(v), x, 0) < v -> size;
+}
+
+u64 vec_find_first(const Vector v, void* x){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error searching in a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    return scan_find(as_view(v), x, 0);
+}
+
+u64 vec_find_all(const Vector v, void* x, Vector indices){
+    handle_err(
+        v == NULL || v -> data == NULL || indices == NULL || indices -> data == NULL,
+        "Error searching in a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        indices -> block_size != sizeof(u64),
+        "the indices vector of find_all must hold u64 ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(indices);
+    indices -> size = 0;
+    index_stale(indices);
+    const VecView all = as_view(v);
+    for(u64 i = scan_find(all, x, 0); i < v -> size; i = scan_find(all, x, i + 1))
+        inline_vec_push(indices, &i);
+    index_settle(indices);
+    return indices -> size;
+}
+
+bool vec_eq(const Vector va, const Vector vb){
+    handle_err(
+        va == NULL || vb == NULL || va -> data == NULL || vb -> data == NULL,
+        "Error in comparing method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        va -> block_size != vb -> block_size,
+        "unresolvable difference in datatypes of source and destination of compare ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    return view_equal(as_view(va), as_view(vb));
+}
+
+void vec_copy(const Vector src, Vector dest){
+     handle_err(
+        src == NULL || dest == NULL || src -> data == NULL || dest -> data == NULL,
+        "Error in copy method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        src -> block_size != dest -> block_size,
+        "unresolvable difference in datatypes of source and destination of copy ! aboring ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(dest);
+    close_gap(src);
+    close_gap(dest);
+    if ( dest -> capacity < src -> size )
+        set_capacity(dest, src -> size);
+    memcpy(dest -> data, src -> data, src -> block_size * src -> size );
+    dest -> size = src -> size;
+    index_refresh(dest);
+}
+
+void vec_clear(const Vector v){ 
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error in clear method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(v);
+    v -> size = 0;
+    v -> gap = VEC_GAP_CLOSED;
+    if ( v -> index != NULL )
+        index_rebuild(v);
+}
+
+u64 vec_count(const Vector v, void* x){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error in count method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    if ( index_live(v) ){
+        const IndexEntry* e = index_lookup(v, x);
+        return e == NULL ? 0 : e -> count;
+    }
+    return scan_count(as_view(v), x);
+}
+
+// branchless lower bound: the range is halved on every step whatever the
+// comparison says, the next two probe positions are prefetched ahead
+static inline u64 bound_search(const u8* data, u64 n, const u32 block_size, void* x,
+        int (*cmp)(void*, void*), const bool upper){
+    if ( UNLIKELY(n == 0) )
+        return 0;
+    const u8* base = data;
+    while ( n > 1 ){
+        const u64 half = n / 2;
+        __builtin_prefetch(base + (half / 2) * block_size);
+        __builtin_prefetch(base + (half + half / 2) * block_size);
+        const int c = CMP(cmp, (void*)(base + half * block_size), x);
+        base += (upper ? c <= 0 : c < 0) * half * block_size;
+        n -= half;
+    }
+    const int c = CMP(cmp, (void*)base, x);
+    return (u64)(base - data) / block_size + (upper ? c <= 0 : c < 0);
+}
+
+static inline u64 binary_search(const VecView v, void* x, bool* found, int (*cmp)(void*, void*)){
+    const u64 i = bound_search(v.data, v.size, v.block_size, x, cmp, false);
+    *found = i < v.size && CMP(cmp, (void*)(v.data + i * v.block_size), x) == 0;
+    return i;
+}
+
+static inline u64 normal_search(const VecView v, void* x, bool* found, int (*cmp)(void*, void*)){
+    u64 i;
+    for(i = 0; i < v.size; i++){
+        if ( CMP(cmp, (void*)(v.data + i * v.block_size), x) == 0 ){
+            *found = true;
+            return i;
+        }
+    }
+    *found = false;
+    return i;
+}
+
+u64 vec_search(const Vector v, void* x, bool* sorted_found, int (*cmp)(void*, void*)){
+    STAT_CMP_BEGIN();
+    const u64 i = *sorted_found == SORTED ?
+        binary_search(as_view(v), x, sorted_found, cmp):
+        normal_search(as_view(v), x, sorted_found, cmp);
+    STAT_CMP_END(v);
+    return i;
+}
+
+u64 vec_lower_bound(const Vector v, void* x, int (*cmp)(void*, void*)){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error searching in a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(v);
+    STAT_CMP_BEGIN();
+    const u64 i = bound_search(v -> data, v -> size, v -> block_size, x, cmp, false);
+    STAT_CMP_END(v);
+    return i;
+}
+
+u64 vec_upper_bound(const Vector v, void* x, int (*cmp)(void*, void*)){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error searching in a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(v);
+    STAT_CMP_BEGIN();
+    const u64 i = bound_search(v -> data, v -> size, v -> block_size, x, cmp, true);
+    STAT_CMP_END(v);
+    return i;
+}
+
+void vec_equal_range(const Vector v, void* x, int (*cmp)(void*, void*), u64* low, u64* high){
+    *low  = vec_lower_bound(v, x, cmp);
+    // the upper bound can only be at or after the lower one
+    STAT_CMP_BEGIN();
+    *high = *low + bound_search(v -> data + *low * v -> block_size, v -> size - *low,
+            v -> block_size, x, cmp, true);
+    STAT_CMP_END(v);
+}
+
+// in order traversal of the implicit tree rooted at k (1 based) which places
+// the sorted elements in breadth first order
+static u64 eytzinger_fill(const u8* sorted, u8* tree, u64 i, u64 k, u64 n, const u32 block_size){
+    if ( k > n )
+        return i;
+    i = eytzinger_fill(sorted, tree, i, 2 * k, n, block_size);
+    memcpy(tree + (k - 1) * block_size, sorted + i * block_size, block_size);
+    return eytzinger_fill(sorted, tree, i + 1, 2 * k + 1, n, block_size);
+}
+
+void vec_build_search_index(const Vector sorted, Vector index){
+    handle_err(
+        sorted == NULL || index == NULL || sorted -> data == NULL || index -> data == NULL,
+        "Error in build search index method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        sorted -> block_size != index -> block_size || sorted == index,
+        "unresolvable difference in datatypes of sorted vector and index ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(sorted);
+    reserve_for(index, sorted -> size);
+    index -> size = sorted -> size;
+    eytzinger_fill(sorted -> data, index -> data, 0, 1, sorted -> size, sorted -> block_size);
+    index_refresh(index);
+}
+
+u64 vec_index_lower_bound(const Vector index, void* x, int (*cmp)(void*, void*)){
+    handle_err(
+        index == NULL || index -> data == NULL,
+        "Error searching in a null vector! aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(index);
+    const u64 n  = index -> size;
+    const u32  bs = index -> block_size;
+    u64 k = 1;
+    STAT_CMP_BEGIN();
+    while ( k <= n ){
+        // the 16 great grand children of k are contiguous, fetch them early
+        __builtin_prefetch(index -> data + (16 * k - 1) * bs);
+        k = 2 * k + (CMP(cmp, index -> data + (k - 1) * bs, x) < 0);
+    }
+    STAT_CMP_END(index);
+    // drop the trailing right turns and the last left one
+    k >>= __builtin_ffsll(~k);
+    return k == 0 ? n : k - 1;
+}
+
+static void map_view(const VecView input, Vector output, void* (*mapper)(void*), u32 input_size, u32 output_size){
+    handle_err(
+        output == NULL || output -> data == NULL,
+        "Error in map method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        input.block_size != input_size || output -> block_size != output_size,
+        "unresolvable difference in datatypes of input, output and function of map ! aboring ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+
+    check_writable(output);
+    close_gap(output);
+    output -> size = 0;
+    index_stale(output);
+    if ( output -> capacity < input.size)
+        set_capacity(output, input.size);
+    for(u64 i = 0; i < input.size; i++)
+        memcpy(
+            output -> data + i * output -> block_size,
+            mapper((void*)(input.data + i * input.block_size)),
+            output -> block_size
+        );
+    output -> size = input.size;
+    index_settle(output);
+}
+
+void vec_map_(const Vector input, Vector output, void* (*mapper)(void*), u32 input_size, u32 output_size){ 
+    handle_err(
+        input == NULL || input -> data == NULL,
+        "Error in map method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    map_view(as_view(input), output, mapper, input_size, output_size);
+}
+
+// batches handed to the user kernels are about this many input bytes, small
+// enough for the input and output of a batch to stay in the l1/l2 cache
+#ifndef VEC_BATCH_BYTES
+    #define VEC_BATCH_BYTES     (16 * 1024)
+#endif
+
+static inline u64 batch_len(const u32 block_size){
+    return VEC_BATCH_BYTES / block_size > 0 ? VEC_BATCH_BYTES / block_size : 1;
+}
+
+void vec_map_batch(const Vector input, Vector output, void (*kernel)(const void* in, void* out, u64 count)){
+    handle_err(
+        input == NULL || output == NULL || input -> data == NULL || output -> data == NULL,
+        "Error in map method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    // strides come from the two vectors, an in place map keeps the element size
+    close_gap(input);
+    reserve_for(output, input -> size);
+    const u64 step = batch_len(input -> block_size);
+    for(u64 i = 0; i < input -> size; i += step)
+        kernel(input -> data + i * input -> block_size,
+            output -> data + i * output -> block_size,
+            input -> size - i < step ? input -> size - i : step);
+    output -> size = input -> size;
+    index_refresh(output);
+}
+
+void vec_map_inplace(Vector v, void (*kernel)(const void* in, void* out, u64 count)){
+    vec_map_batch(v, v, kernel);
+}
+
+u64 vec_filter(const Vector input, Vector output, bool (*pred)(const void* x, void* ctx), void* ctx){
+    handle_err(
+        input == NULL || output == NULL || input -> data == NULL || output -> data == NULL,
+        "Error in filter method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        input -> block_size != output -> block_size,
+        "unresolvable difference in datatypes of input, output of filter ! aboring ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(input);
+    reserve_for(output, input -> size);
+    const u32 bs = input -> block_size;
+    u64 kept = 0;
+    // kept <= i, so filtering a vector into itself compacts it in place
+    for(u64 i = 0; i < input -> size; i++){
+        const u8* x = input -> data + i * bs;
+        if ( !pred(x, ctx) )
+            continue;
+        if ( output != input || kept != i )
+            copy_block(output -> data + kept * bs, x, bs);
+        kept++;
+    }
+    output -> size = kept;
+    index_refresh(output);
+    return kept;
+}
+
+void vec_fold(const Vector v, void* acc, void (*step)(void* acc, const void* x)){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error in fold method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(v);
+    for(u64 i = 0; i < v -> size; i++)
+        step(acc, v -> data + i * v -> block_size);
+}
+
+void vec_reduce(const Vector v, void* acc, void (*kernel)(void* acc, const void* xs, u64 count)){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error in reduce method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(v);
+    const u64 step = batch_len(v -> block_size);
+    for(u64 i = 0; i < v -> size; i += step)
+        kernel(acc, v -> data + i * v -> block_size, v -> size - i < step ? v -> size - i : step);
+}
+
+#define VEC_MAX_THREADS         256
+
+// thread pool: the caller runs share 0 of every job and the pool threads the
+// others, chunks are split the same way for a given length and pool size so
+// the results never depend on scheduling
+#ifndef VEC_POOL_GRAIN
+    #define VEC_POOL_GRAIN      4096    // fewest elements worth a thread
+#endif
+
+typedef struct{
+    pthread_t   thread      ;
+    u8*         scratch     ;           // private to the worker, never shared
+    u64         scratch_size;
+    u64         count       ;
+} __attribute__((aligned(64))) PoolWorker;
+
+struct vec_pool{
+    pthread_mutex_t lock        ;
+    pthread_cond_t  wake        ;
+    pthread_cond_t  done        ;
+    void          (*job)(VecPool, u32 worker, u32 shares, void* arg);
+    void*           arg         ;
+    u32             shares      ;
+    u32             pending     ;
+    u64             generation  ;
+    bool            stop        ;
+    u32             nworkers    ;
+    PoolWorker*     workers     ;
+};
+
+typedef struct{
+    VecPool pool;
+    u32     index;
+} PoolStart;
+
+static void* pool_thread(void* arg){
+    const PoolStart start = *(PoolStart*)arg;
+    free(arg);
+    VecPool pool = start.pool;
+    u64 seen = 0;
+    pthread_mutex_lock(&pool -> lock);
+    for(;;){
+        while ( !pool -> stop && pool -> generation == seen )
+            pthread_cond_wait(&pool -> wake, &pool -> lock);
+        if ( pool -> stop )
+            break;
+        seen = pool -> generation;
+        if ( start.index >= pool -> shares )
+            continue;
+        pthread_mutex_unlock(&pool -> lock);
+        pool -> job(pool, start.index, pool -> shares, pool -> arg);
+        pthread_mutex_lock(&pool -> lock);
+        if ( --pool -> pending == 0 )
+            pthread_cond_signal(&pool -> done);
+    }
+    pthread_mutex_unlock(&pool -> lock);
+    return NULL;
+}
+
+VecPool vec_pool_create(u32 nthreads){
+    if ( nthreads == 0 ){
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = online > 0 ? (u32)online : 1;
+    }
+    if ( nthreads > VEC_MAX_THREADS )
+        nthreads = VEC_MAX_THREADS;
+    VecPool pool = (VecPool)calloc(1, sizeof(struct vec_pool));
+    PoolWorker* workers = (PoolWorker*)aligned_alloc(64, nthreads * sizeof(PoolWorker));
+    handle_err(
+        pool == NULL || workers == NULL,
+        "Error Allocating Space for the thread pool! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    memset(workers, 0, nthreads * sizeof(PoolWorker));
+    pthread_mutex_init(&pool -> lock, NULL);
+    pthread_cond_init(&pool -> wake, NULL);
+    pthread_cond_init(&pool -> done, NULL);
+    pool -> workers  = workers;
+    pool -> nworkers = 1;
+    // worker 0 is the calling thread
+    for(u32 i = 1; i < nthreads; i++){
+        PoolStart* start = (PoolStart*)malloc(sizeof(PoolStart));
+        handle_err(
+            start == NULL,
+            "Error Allocating Space for the thread pool! Aborting ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        *start = (PoolStart){ pool, i };
+        if ( pthread_create(&workers[i].thread, NULL, pool_thread, start) != 0 ){
+            free(start);
+            break;
+        }
+        pool -> nworkers++;
+    }
+    return pool;
+}
+
+void vec_pool_destroy(VecPool pool){
+    pthread_mutex_lock(&pool -> lock);
+    pool -> stop = true;
+    pthread_cond_broadcast(&pool -> wake);
+    pthread_mutex_unlock(&pool -> lock);
+    for(u32 i = 1; i < pool -> nworkers; i++)
+        pthread_join(pool -> workers[i].thread, NULL);
+    for(u32 i = 0; i < pool -> nworkers; i++)
+        free(pool -> workers[i].scratch);
+    pthread_mutex_destroy(&pool -> lock);
+    pthread_cond_destroy(&pool -> wake);
+    pthread_cond_destroy(&pool -> done);
+    free(pool -> workers);
+    free(pool);
+}
+
+u32 vec_pool_size(const VecPool pool){ return pool -> nworkers; }
+
+// how many workers a job over n elements is split across
+static inline u32 pool_shares(const VecPool pool, u64 n){
+    const u64 useful = (n + VEC_POOL_GRAIN - 1) / VEC_POOL_GRAIN;
+    return useful == 0 ? 1 : useful < pool -> nworkers ? (u32)useful : pool -> nworkers;
+}
+
+static inline u64 pool_split(u64 n, u32 share, u32 shares){
+    return n / shares * share + (n % shares) * share / shares;
+}
+
+// makes sure every worker taking part has size bytes of private scratch
+static void pool_scratch(VecPool pool, u32 shares, u64 size){
+    for(u32 i = 0; i < shares; i++){
+        PoolWorker* w = &pool -> workers[i];
+        if ( w -> scratch_size >= size )
+            continue;
+        free(w -> scratch);
+        w -> scratch = (u8*)malloc(size);
+        handle_err(
+            w -> scratch == NULL,
+            "Error Allocating the scratch space of the thread pool! Aborting ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        w -> scratch_size = size;
+    }
+}
+
+static void pool_run(VecPool pool, u32 shares, void (*job)(VecPool, u32, u32, void*), void* arg){
+    if ( shares > 1 ){
+        pthread_mutex_lock(&pool -> lock);
+        pool -> job     = job;
+        pool -> arg     = arg;
+        pool -> shares  = shares;
+        pool -> pending = shares - 1;
+        pool -> generation++;
+        pthread_cond_broadcast(&pool -> wake);
+        pthread_mutex_unlock(&pool -> lock);
+    }
+    job(pool, 0, shares, arg);
+    if ( shares > 1 ){
+        pthread_mutex_lock(&pool -> lock);
+        while ( pool -> pending != 0 )
+            pthread_cond_wait(&pool -> done, &pool -> lock);
+        pthread_mutex_unlock(&pool -> lock);
+    }
+}
+
+typedef struct{
+    const Vector  input;
+    Vector        output;
+    void        (*kernel)(const void*, void*, u64);
+    bool        (*pred)(const void*, void*);
+    void        (*reduce)(void*, const void*, u64);
+    void*         ctx;
+    const u64*    offsets;
+} PoolJob;
+
+static void pool_map_job(VecPool pool, u32 share, u32 shares, void* arg){
+    (void)pool;
+    const PoolJob* job = (const PoolJob*)arg;
+    const u64 lo   = pool_split(job -> input -> size, share, shares);
+    const u64 hi   = pool_split(job -> input -> size, share + 1, shares);
+    const u64 step = batch_len(job -> input -> block_size);
+    for(u64 i = lo; i < hi; i += step)
+        job -> kernel(job -> input -> data + i * job -> input -> block_size,
+            job -> output -> data + i * job -> output -> block_size,
+            hi - i < step ? hi - i : step);
+}
+
+void vec_pool_map(VecPool pool, const Vector input, Vector output, void (*kernel)(const void* in, void* out, u64 count)){
+    handle_err(
+        input == NULL || output == NULL || input -> data == NULL || output -> data == NULL,
+        "Error in map method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    // strides come from the two vectors, an in place map keeps the element size
+    close_gap(input);
+    reserve_for(output, input -> size);
+    PoolJob job = { .input = input, .output = output, .kernel = kernel };
+    pool_run(pool, pool_shares(pool, input -> size), pool_map_job, &job);
+    output -> size = input -> size;
+    index_refresh(output);
+}
+
+// first pass of filter: count what each chunk keeps, or compact the chunk in
+// place when filtering a vector into itself
+static void pool_filter_count_job(VecPool pool, u32 share, u32 shares, void* arg){
+    const PoolJob* job = (const PoolJob*)arg;
+    const u32  bs = job -> input -> block_size;
+    const u64 lo = pool_split(job -> input -> size, share, shares);
+    const u64 hi = pool_split(job -> input -> size, share + 1, shares);
+    const bool inplace = job -> input == job -> output;
+    u64 kept = 0;
+    for(u64 i = lo; i < hi; i++){
+        const u8* x = job -> input -> data + i * bs;
+        if ( !job -> pred(x, job -> ctx) )
+            continue;
+        if ( inplace && lo + kept != i )
+            copy_block(job -> input -> data + (lo + kept) * bs, x, bs);
+        kept++;
+    }
+    pool -> workers[share].count = kept;
+}
+
+// second pass of filter: every chunk writes at its prefix sum offset
+static void pool_filter_write_job(VecPool pool, u32 share, u32 shares, void* arg){
+    (void)pool;
+    const PoolJob* job = (const PoolJob*)arg;
+    const u32  bs = job -> input -> block_size;
+    const u64 lo = pool_split(job -> input -> size, share, shares);
+    const u64 hi = pool_split(job -> input -> size, share + 1, shares);
+    u8* out = job -> output -> data + job -> offsets[share] * bs;
+    for(u64 i = lo; i < hi; i++){
+        const u8* x = job -> input -> data + i * bs;
+        if ( job -> pred(x, job -> ctx) ){
+            copy_block(out, x, bs);
+            out += bs;
+        }
+    }
+}
+
+u64 vec_pool_filter(VecPool pool, const Vector input, Vector output, bool (*pred)(const void* x, void* ctx), void* ctx){
+    handle_err(
+        input == NULL || output == NULL || input -> data == NULL || output -> data == NULL,
+        "Error in filter method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        input -> block_size != output -> block_size,
+        "unresolvable difference in datatypes of input, output of filter ! aboring ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(output);
+    close_gap(input);
+    close_gap(output);
+    const u32  bs     = input -> block_size;
+    const u32 shares = pool_shares(pool, input -> size);
+    u64 offsets[shares + 1];
+    PoolJob job = { .input = input, .output = output, .pred = pred, .ctx = ctx, .offsets = offsets };
+    pool_run(pool, shares, pool_filter_count_job, &job);
+    offsets[0] = 0;
+    for(u32 i = 0; i < shares; i++)
+        offsets[i + 1] = offsets[i] + pool -> workers[i].count;
+
+    if ( input == output ){
+        // chunks are already compacted, slide them down in order
+        for(u32 i = 1; i < shares; i++)
+            memmove(output -> data + offsets[i] * bs,
+                output -> data + pool_split(input -> size, i, shares) * bs,
+                pool -> workers[i].count * bs);
+    } else {
+        reserve_for(output, offsets[shares]);
+        pool_run(pool, shares, pool_filter_write_job, &job);
+    }
+    output -> size = offsets[shares];
+    index_refresh(output);
+    return output -> size;
+}
+
+static void pool_reduce_job(VecPool pool, u32 share, u32 shares, void* arg){
+    const PoolJob* job = (const PoolJob*)arg;
+    const u64 lo   = pool_split(job -> input -> size, share, shares);
+    const u64 hi   = pool_split(job -> input -> size, share + 1, shares);
+    const u64 step = batch_len(job -> input -> block_size);
+    void* acc = pool -> workers[share].scratch;
+    for(u64 i = lo; i < hi; i += step)
+        job -> reduce(acc, job -> input -> data + i * job -> input -> block_size, hi - i < step ? hi - i : step);
+}
+
+void vec_pool_reduce(VecPool pool, const Vector v, void* acc, const void* identity, u64 acc_size,
+        void (*kernel)(void* acc, const void* xs, u64 count), void (*combine)(void* acc, const void* other)){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error in reduce method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(v);
+    const u32 shares = pool_shares(pool, v -> size);
+    pool_scratch(pool, shares, acc_size);
+    for(u32 i = 0; i < shares; i++)
+        memcpy(pool -> workers[i].scratch, identity, acc_size);
+    PoolJob job = { .input = v, .reduce = kernel };
+    pool_run(pool, shares, pool_reduce_job, &job);
+    // partial results are combined in chunk order
+    for(u32 i = 0; i < shares; i++)
+        combine(acc, pool -> workers[i].scratch);
+}
+
+// concurrent vector: bucket b holds VEC_CONCURRENT_FIRST << b elements, so the
+// buckets double like a regular vector would but none of them is ever moved.
+// a push claims its slot with a fetch-add, writes the element then raises the
+// slot's ready flag, and whoever sees the flags right after len set moves len
+// past them, so len only ever covers fully written elements
+#define VEC_CONCURRENT_SHIFT    6
+#define VEC_CONCURRENT_FIRST    (1ull << VEC_CONCURRENT_SHIFT)
+#define VEC_CONCURRENT_BUCKETS  (64 - VEC_CONCURRENT_SHIFT)
+
+struct vec_concurrent{
+    u8*     buckets[VEC_CONCURRENT_BUCKETS];    // elements then one ready flag per slot
+    u32     block_size;
+    // each counter on its own cache line, pushers hammer both
+    _Alignas(64) u64 claimed;
+    _Alignas(64) u64 committed;
+};
+
+static inline u32 slot_bucket(const u64 index){
+    return 63 - __builtin_clzll(index + VEC_CONCURRENT_FIRST) - VEC_CONCURRENT_SHIFT;
+}
+
+static inline u64 slot_offset(const u64 index, const u32 bucket){
+    return index + VEC_CONCURRENT_FIRST - (VEC_CONCURRENT_FIRST << bucket);
+}
+
+static inline u64 bucket_len(const u32 bucket){
+    return VEC_CONCURRENT_FIRST << bucket;
+}
+
+// the first thread to need a bucket installs it, the losers of the race free theirs
+static u8* concurrent_bucket(ConcurrentVector cv, const u32 bucket){
+    u8* b = __atomic_load_n(&cv -> buckets[bucket], __ATOMIC_ACQUIRE);
+    if ( LIKELY(b != NULL) )
+        return b;
+    u8* fresh = (u8*)calloc(bucket_len(bucket), (u64)cv -> block_size + 1);
+    handle_err(
+        fresh == NULL,
+        "Error Allocating Space for the Concurrent Vector! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    if ( __atomic_compare_exchange_n(&cv -> buckets[bucket], &b, fresh, false,
+            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) )
+        return fresh;
+    free(fresh);
+    return b;
+}
+
+static inline u8* slot_flag(const ConcurrentVector cv, u8* bucket, const u32 b, const u64 offset){
+    return bucket + bucket_len(b) * cv -> block_size + offset;
+}
+
+// seq_cst on the flags and len: a pusher raises its flag then reads len while
+// the one committing the slot before it moves len then reads that flag,
+// one of the two has to see the other's write
+static bool slot_ready(const ConcurrentVector cv, const u64 index){
+    const u32 b = slot_bucket(index);
+    u8* bucket = __atomic_load_n(&cv -> buckets[b], __ATOMIC_ACQUIRE);
+    return bucket != NULL &&
+        __atomic_load_n(slot_flag(cv, bucket, b, slot_offset(index, b)), __ATOMIC_SEQ_CST);
+}
+
+ConcurrentVector vec_concurrent_create(u32 block_size){
+    handle_err(
+        block_size == 0,
+        "Error the block size of a Concurrent Vector can't be 0! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    ConcurrentVector cv = (ConcurrentVector)aligned_alloc(64, sizeof(struct vec_concurrent));
+    handle_err(
+        cv == NULL,
+        "Error Allocating Space for the Concurrent Vector! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    memset(cv, 0, sizeof(struct vec_concurrent));
+    cv -> block_size = block_size;
+    concurrent_bucket(cv, 0);
+    return cv;
+}
+
+void vec_concurrent_destroy(ConcurrentVector cv){
+    for(u32 b = 0; b < VEC_CONCURRENT_BUCKETS; b++)
+        free(cv -> buckets[b]);
+    free(cv);
+}
+
+u64 vec_concurrent_push(ConcurrentVector cv, const void* x){
+    const u64 index  = __atomic_fetch_add(&cv -> claimed, 1, __ATOMIC_RELAXED);
+    const u32 b      = slot_bucket(index);
+    const u64 offset = slot_offset(index, b);
+    u8* bucket = concurrent_bucket(cv, b);
+    // the first one in a bucket sets up the next, it is usually there before anyone needs it
+    if ( UNLIKELY(offset == 0 && b + 1 < VEC_CONCURRENT_BUCKETS) )
+        concurrent_bucket(cv, b + 1);
+    memcpy(bucket + offset * cv -> block_size, x, cv -> block_size);
+    __atomic_store_n(slot_flag(cv, bucket, b, offset), 1, __ATOMIC_SEQ_CST);
+
+    u64 len = __atomic_load_n(&cv -> committed, __ATOMIC_SEQ_CST);
+    while ( slot_ready(cv, len) ){
+        // a failed exchange reloads len, someone else moved it
+        if ( __atomic_compare_exchange_n(&cv -> committed, &len, len + 1, false,
+                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) )
+            len++;
+    }
+    return index;
+}
+
+u64 vec_concurrent_len(const ConcurrentVector cv){
+    return __atomic_load_n(&cv -> committed, __ATOMIC_ACQUIRE);
+}
+
+void* vec_concurrent_at(const ConcurrentVector cv, u64 index){
+    handle_err(
+        index >= vec_concurrent_len(cv),
+        "Out Of Bounds Error ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    const u32 b = slot_bucket(index);
+    return __atomic_load_n(&cv -> buckets[b], __ATOMIC_ACQUIRE) + slot_offset(index, b) * cv -> block_size;
+}
+
+void vec_concurrent_get(const ConcurrentVector cv, u64 index, void* gottem){
+    memcpy(gottem, vec_concurrent_at(cv, index), cv -> block_size);
+}
+
+void vec_concurrent_collect(const ConcurrentVector cv, Vector out){
+    handle_err(
+        out -> data == NULL || out -> block_size != cv -> block_size,
+        "unresolvable difference in datatypes of the Concurrent Vector and the output ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    const u64 n  = vec_concurrent_len(cv);
+    const u32 bs = cv -> block_size;
+    reserve_for(out, n);
+    for(u64 i = 0; i < n; ){
+        const u32 b = slot_bucket(i);
+        const u64 count = bucket_len(b) < n - i ? bucket_len(b) : n - i;
+        memcpy(out -> data + i * bs, __atomic_load_n(&cv -> buckets[b], __ATOMIC_ACQUIRE), count * bs);
+        i += count;
+    }
+    out -> size = n;
+    index_refresh(out);
+}
+
+// packed vectors: full blocks of VEC_PACK_BLOCK values are stored as offsets
+// (frame of reference) or gaps (delta) bit packed at the width of the widest
+// one, value j of a block at bit j * bits, so a block takes 2 * bits words.
+// the words sit back to back with one zero word past the last so that the
+// decoders can always read the word after the one a value starts in.
+// bitvectors are blocks of width 1 that need no base, width or offset
+#define PACK_WORDS(bits)    (2 * (u64)(bits))
+
+struct vec_packed{
+    u64*    words;
+    u64     nwords;
+    u64     capwords;
+    u64*    base;               // block minimum (for) or first value (delta)
+    u64*    offset;             // first word of each block
+    u8*     bits;
+    u64     blocks;
+    u64     capblocks;
+    u64     len;
+    u32     tail_len;
+    u8      mode;
+    u64     tail[VEC_PACK_BLOCK];   // the last, not yet full block as plain values
+};
+
+static inline u64 pack_mask(const u32 bits){
+    return bits == 64 ? ~0ull : (1ull << bits) - 1;
+}
+
+static inline u32 pack_width(const u64 x){
+    return x == 0 ? 0 : 64 - __builtin_clzll(x);
+}
+
+static void unpack_scalar(const u64* w, u32 bits, u64 base, u64* out){
+    const u64 mask = pack_mask(bits);
+    for(u32 j = 0; j < VEC_PACK_BLOCK; j++){
+        const u64 pos = (u64)j * bits;
+        const u32 s   = pos & 63;
+        u64 x = w[pos >> 6] >> s;
+        if ( s + bits > 64 )
+            x |= w[(pos >> 6) + 1] << (64 - s);
+        out[j] = (x & mask) + base;
+    }
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+// four values per step: gather the word each one starts in and the next,
+// shift both into place and merge. a shift by 64 gives 0 in sllv, so values
+// that sit in a single word need no special case
+AVX2_ATTR static void unpack_avx2(const u64* w, u32 bits, u64 base, u64* out){
+    const __m256i mask = _mm256_set1_epi64x((long long)pack_mask(bits));
+    const __m256i add  = _mm256_set1_epi64x((long long)base);
+    const __m256i step = _mm256_set1_epi64x(4ll * bits);
+    const __m256i m63  = _mm256_set1_epi64x(63);
+    const __m256i c64  = _mm256_set1_epi64x(64);
+    const __m256i one  = _mm256_set1_epi64x(1);
+    __m256i pos = _mm256_setr_epi64x(0, bits, 2ll * bits, 3ll * bits);
+    for(u32 j = 0; j < VEC_PACK_BLOCK; j += 4){
+        const __m256i i  = _mm256_srli_epi64(pos, 6);
+        const __m256i s  = _mm256_and_si256(pos, m63);
+        const __m256i lo = _mm256_i64gather_epi64((const long long*)w, i, 8);
+        const __m256i hi = _mm256_i64gather_epi64((const long long*)w, _mm256_add_epi64(i, one), 8);
+        __m256i x = _mm256_or_si256(_mm256_srlv_epi64(lo, s), _mm256_sllv_epi64(hi, _mm256_sub_epi64(c64, s)));
+        x = _mm256_add_epi64(_mm256_and_si256(x, mask), add);
+        _mm256_storeu_si256((__m256i*)(out + j), x);
+        pos = _mm256_add_epi64(pos, step);
+    }
+}
+#endif
+
+static void (*unpack_block)(const u64*, u32, u64, u64*) = unpack_scalar;
+
+__attribute__((constructor)) static void pack_dispatch(void){
+#if defined(__x86_64__) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports("avx2") )
+        unpack_block = unpack_avx2;
+#endif
+}
+
+static inline u64 block_first_word(const PackedVector p, const u64 k){
+    return p -> mode == VEC_PACK_BITS ? PACK_WORDS(1) * k : p -> offset[k];
+}
+
+static inline u32 block_bits(const PackedVector p, const u64 k){
+    return p -> mode == VEC_PACK_BITS ? 1 : p -> bits[k];
+}
+
+// decodes full block k into out, a block of width 0 holds its base only
+static void decode_block(const PackedVector p, const u64 k, u64* out){
+    const u32 bits = block_bits(p, k);
+    const u64 base = p -> mode == VEC_PACK_FOR ? p -> base[k] : 0;
+    if ( bits == 0 ){
+        for(u32 j = 0; j < VEC_PACK_BLOCK; j++)
+            out[j] = base;
+    }
+    else
+        unpack_block(p -> words + block_first_word(p, k), bits, base, out);
+    if ( p -> mode == VEC_PACK_DELTA ){
+        u64 acc = p -> base[k];
+        for(u32 j = 0; j < VEC_PACK_BLOCK; j++)
+            out[j] = acc += out[j];
+    }
+}
+
+static void* pack_grow(void* ptr, u64* capa, const u64 needed, const u64 elem){
+    if ( needed <= *capa )
+        return ptr;
+    u64 c = *capa == 0 ? 8 : *capa;
+    while ( c < needed )
+        c *= 2;
+    void* fresh = realloc(ptr, c * elem);
+    handle_err(
+        fresh == NULL,
+        "Error Allocating Space for the Packed Vector! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    *capa = c;
+    return fresh;
+}
+
+// turns the full tail into a block
+static void pack_tail(PackedVector p){
+    u64 d[VEC_PACK_BLOCK];
+    u64 base = 0, wide = 0;
+    if ( p -> mode == VEC_PACK_FOR ){
+        base = p -> tail[0];
+        for(u32 j = 1; j < VEC_PACK_BLOCK; j++)
+            base = p -> tail[j] < base ? p -> tail[j] : base;
+        for(u32 j = 0; j < VEC_PACK_BLOCK; j++)
+            wide |= d[j] = p -> tail[j] - base;
+    }
+    else if ( p -> mode == VEC_PACK_DELTA ){
+        base = p -> tail[0];
+        d[0] = 0;
+        for(u32 j = 1; j < VEC_PACK_BLOCK; j++)
+            wide |= d[j] = p -> tail[j] - p -> tail[j - 1];
+    }
+    else
+        memcpy(d, p -> tail, sizeof(d));
+    const u32 bits = p -> mode == VEC_PACK_BITS ? 1 : pack_width(wide);
+
+    const u64 first = p -> nwords;
+    p -> words = (u64*)pack_grow(p -> words, &p -> capwords, first + PACK_WORDS(bits) + 1, sizeof(u64));
+    u64* w = p -> words + first;
+    memset(w, 0, (PACK_WORDS(bits) + 1) * sizeof(u64));
+    for(u32 j = 0; bits != 0 && j < VEC_PACK_BLOCK; j++){
+        const u64 pos = (u64)j * bits;
+        const u32 s   = pos & 63;
+        w[pos >> 6] |= d[j] << s;
+        if ( s + bits > 64 )
+            w[(pos >> 6) + 1] |= d[j] >> (64 - s);
+    }
+    p -> nwords += PACK_WORDS(bits);
+
+    if ( p -> mode != VEC_PACK_BITS ){
+        u64 capa = p -> capblocks;
+        p -> base   = (u64*)pack_grow(p -> base, &capa, p -> blocks + 1, sizeof(u64));
+        capa = p -> capblocks;
+        p -> offset = (u64*)pack_grow(p -> offset, &capa, p -> blocks + 1, sizeof(u64));
+        p -> bits   = (u8*)pack_grow(p -> bits, &p -> capblocks, p -> blocks + 1, sizeof(u8));
+        p -> base[p -> blocks]   = base;
+        p -> offset[p -> blocks] = first;
+        p -> bits[p -> blocks]   = bits;
+    }
+    p -> blocks++;
+    p -> tail_len = 0;
+}
+
+PackedVector vec_packed_create(u8 mode){
+    handle_err(
+        mode > VEC_PACK_BITS,
+        "Error unknown packing mode for a Packed Vector! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    PackedVector p = (PackedVector)calloc(1, sizeof(struct vec_packed));
+    handle_err(
+        p == NULL,
+        "Error Allocating Space for the Packed Vector! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    p -> mode = mode;
+    return p;
+}
+
+void vec_packed_destroy(PackedVector p){
+    free(p -> words);
+    free(p -> base);
+    free(p -> offset);
+    free(p -> bits);
+    free(p);
+}
+
+void vec_packed_push(PackedVector p, u64 x){
+    handle_err(
+        p -> mode == VEC_PACK_BITS && x > 1,
+        "Error a packed bitvector only holds 0 and 1! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        p -> mode == VEC_PACK_DELTA && p -> len != 0 &&
+            x < (p -> tail_len != 0 ? p -> tail[p -> tail_len - 1] : vec_packed_get(p, p -> len - 1)),
+        "Error a delta packed Vector only takes non decreasing values! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    p -> tail[p -> tail_len++] = x;
+    p -> len++;
+    if ( p -> tail_len == VEC_PACK_BLOCK )
+        pack_tail(p);
+}
+
+u64 vec_packed_get(const PackedVector p, u64 index){
+    handle_err(
+        index >= p -> len,
+        "Out Of Bounds Error ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    const u64 k = index / VEC_PACK_BLOCK;
+    const u32 j = index % VEC_PACK_BLOCK;
+    if ( k == p -> blocks )
+        return p -> tail[j];
+    if ( p -> mode == VEC_PACK_DELTA ){
+        u64 out[VEC_PACK_BLOCK];
+        decode_block(p, k, out);
+        return out[j];
+    }
+    const u32 bits = block_bits(p, k);
+    const u64* w   = p -> words + block_first_word(p, k);
+    const u64 pos  = (u64)j * bits;
+    const u32 s    = pos & 63;
+    u64 x = bits == 0 ? 0 : w[pos >> 6] >> s;
+    if ( s + bits > 64 )
+        x |= w[(pos >> 6) + 1] << (64 - s);
+    return (x & pack_mask(bits)) + (p -> mode == VEC_PACK_FOR ? p -> base[k] : 0);
+}
+
+u64 vec_packed_len(const PackedVector p){
+    return p -> len;
+}
+
+// what the vector holds on to, allocated but unused room included
+u64 vec_packed_bytes(const PackedVector p){
+    return sizeof(struct vec_packed) + p -> capwords * sizeof(u64) +
+        p -> capblocks * (2 * sizeof(u64) + sizeof(u8));
+}
+
+static u64 search_tail(const PackedVector p, const u64 x){
+    for(u32 j = 0; j < p -> tail_len; j++)
+        if ( p -> tail[j] == x )
+            return p -> blocks * VEC_PACK_BLOCK + j;
+    return p -> len;
+}
+
+static u64 search_block(const PackedVector p, const u64 k, const u64 x){
+    u64 out[VEC_PACK_BLOCK];
+    decode_block(p, k, out);
+    for(u32 j = 0; j < VEC_PACK_BLOCK; j++)
+        if ( out[j] == x )
+            return k * VEC_PACK_BLOCK + j;
+    return p -> len;
+}
+
+// for skips every block whose range can't hold x, delta binary searches the
+// first values and decodes at most one block, bits looks for a set (or
+// clear) bit a word at a time
+u64 vec_packed_search(const PackedVector p, u64 x){
+    if ( p -> mode == VEC_PACK_BITS ){
+        if ( x > 1 )
+            return p -> len;
+        const u64 flip = x ? 0 : ~0ull;
+        for(u64 i = 0; i < p -> nwords; i++)
+            if ( (p -> words[i] ^ flip) != 0 )
+                return i * 64 + __builtin_ctzll(p -> words[i] ^ flip);
+        return search_tail(p, x);
+    }
+    if ( p -> mode == VEC_PACK_FOR ){
+        for(u64 k = 0; k < p -> blocks; k++){
+            if ( x < p -> base[k] || x - p -> base[k] > pack_mask(p -> bits[k]) )
+                continue;
+            const u64 at = search_block(p, k, x);
+            if ( at != p -> len )
+                return at;
+        }
+        return search_tail(p, x);
+    }
+    // first block starting at x or past it, an earlier copy of x can only
+    // sit at the end of the block before
+    u64 lo = 0, hi = p -> blocks;
+    while ( lo < hi ){
+        const u64 mid = lo + (hi - lo) / 2;
+        if ( p -> base[mid] < x )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if ( lo > 0 ){
+        const u64 at = search_block(p, lo - 1, x);
+        if ( at != p -> len )
+            return at;
+    }
+    if ( lo < p -> blocks )
+        return p -> base[lo] == x ? lo * VEC_PACK_BLOCK : p -> len;
+    return search_tail(p, x);
+}
+
+void vec_packed_iter(const PackedVector p, VecPackedIter* it){
+    it -> p    = p;
+    it -> next = 0;
+    it -> at   = 0;
+    it -> len  = 0;
+}
+
+bool vec_packed_next(VecPackedIter* it, u64* x){
+    const struct vec_packed* p = it -> p;
+    if ( UNLIKELY(it -> at == it -> len) ){
+        if ( it -> next >= p -> len )
+            return false;
+        const u64 k = it -> next / VEC_PACK_BLOCK;
+        if ( k < p -> blocks ){
+            decode_block((PackedVector)p, k, it -> buf);
+            it -> len = VEC_PACK_BLOCK;
+        }
+        else {
+            memcpy(it -> buf, p -> tail, p -> tail_len * sizeof(u64));
+            it -> len = p -> tail_len;
+        }
+        it -> at = 0;
+    }
+    *x = it -> buf[it -> at++];
+    it -> next++;
+    return true;
+}
+
+static inline bool packable_width(const u32 bs){
+    return bs == 1 || bs == 2 || bs == 4 || bs == 8;
+}
+
+static inline u64 load_uint(const u8* src, const u32 bs){
+    switch ( bs ){
+        case 1:  return *src;
+        case 2:  { uint16_t x; memcpy(&x, src, 2); return x; }
+        case 4:  { u32 x; memcpy(&x, src, 4); return x; }
+        default: { u64 x; memcpy(&x, src, 8); return x; }
+    }
+}
+
+static inline void store_uint(u8* dst, const u64 x, const u32 bs){
+    switch ( bs ){
+        case 1:  *dst = (u8)x; break;
+        case 2:  { uint16_t y = (uint16_t)x; memcpy(dst, &y, 2); break; }
+        case 4:  { u32 y = (u32)x; memcpy(dst, &y, 4); break; }
+        default: memcpy(dst, &x, 8);
+    }
+}
+
+PackedVector vec_pack(const Vector v, u8 mode){
+    handle_err(
+        v -> data == NULL || !packable_width(v -> block_size),
+        "Error only Vectors of 1, 2, 4 or 8 byte integers can be packed! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    PackedVector p = vec_packed_create(mode);
+    for(u64 i = 0; i < v -> size; i++)
+        vec_packed_push(p, load_uint(element_at(v, i), v -> block_size));
+    return p;
+}
+
+// blocks are decoded straight into out, and a value too wide for its
+// elements is caught once per block
+void vec_unpack(const PackedVector p, Vector out){
+    const u32 bs = out -> block_size;
+    handle_err(
+        out -> data == NULL || !packable_width(bs),
+        "Error only Vectors of 1, 2, 4 or 8 byte integers can be unpacked into! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    const u64 limit = bs == 8 ? ~0ull : (1ull << (bs * 8)) - 1;
+    reserve_for(out, p -> len);
+    u64 buf[VEC_PACK_BLOCK];
+    for(u64 k = 0; k <= p -> blocks; k++){
+        const u64* src = buf;
+        u32 n = VEC_PACK_BLOCK;
+        if ( k < p -> blocks )
+            decode_block(p, k, buf);
+        else {
+            src = p -> tail;
+            n = p -> tail_len;
+        }
+        u64 wide = 0;
+        for(u32 j = 0; j < n; j++)
+            wide |= src[j];
+        handle_err(
+            wide > limit,
+            "Error a packed value doesn't fit the elements of the Vector! Aborting ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        u8* dst = out -> data + k * VEC_PACK_BLOCK * bs;
+        if ( bs == 8 )
+            memcpy(dst, src, n * sizeof(u64));
+        else
+            for(u32 j = 0; j < n; j++)
+                store_uint(dst + j * bs, src[j], bs);
+    }
+    out -> size = p -> len;
+    index_refresh(out);
+}
+
+// sorting engine: pattern defeating introsort (pdqsort) over raw blocks
+
+#define INSERTION_SORT_THRESHOLD    24
+#define NINTHER_THRESHOLD           128
+#define PARTIAL_INSERTION_LIMIT     8
+
+typedef struct{
+    u32                block_size;
+    int              (*cmp)(void*, void*);
+    u8*                tmp;                 // one block of scratch for the whole sort
+} SortCtx;
+
+#define AT(base, i)     ((base) + (u64)(i) * ctx -> block_size)
+#define LESS(a, b)      (CMP(ctx -> cmp, (void*)(a), (void*)(b)) < 0)
+
+static inline void sort2(u8* a, u8* b, const SortCtx* ctx){
+    if ( LESS(b, a) )
+        swap(a, b, ctx -> block_size);
+}
+
+static inline void sort3(u8* a, u8* b, u8* c, const SortCtx* ctx){
+    sort2(a, b, ctx);
+    sort2(b, c, ctx);
+    sort2(a, b, ctx);
+}
+
+static void insertion_sort(u8* base, u64 n, const SortCtx* ctx){
+    const u32 bs = ctx -> block_size;
+    for(u64 cur = 1; cur < n; cur++){
+        if ( !LESS(AT(base, cur), AT(base, cur - 1)) )
+            continue;
+        memcpy(ctx -> tmp, AT(base, cur), bs);
+        u64 j = cur - 1;
+        while ( j > 0 && LESS(ctx -> tmp, AT(base, j - 1)) )
+            j--;
+        memmove(AT(base, j + 1), AT(base, j), (cur - j) * bs);
+        memcpy(AT(base, j), ctx -> tmp, bs);
+    }
+}
+
+// same as insertion_sort but gives up once more than PARTIAL_INSERTION_LIMIT
+// elements were moved, returns whether the range ended up sorted
+static bool partial_insertion_sort(u8* base, u64 n, const SortCtx* ctx){
+    const u32 bs = ctx -> block_size;
+    u64 moved = 0;
+    for(u64 cur = 1; cur < n; cur++){
+        if ( !LESS(AT(base, cur), AT(base, cur - 1)) )
+            continue;
+        memcpy(ctx -> tmp, AT(base, cur), bs);
+        u64 j = cur - 1;
+        while ( j > 0 && LESS(ctx -> tmp, AT(base, j - 1)) )
+            j--;
+        memmove(AT(base, j + 1), AT(base, j), (cur - j) * bs);
+        memcpy(AT(base, j), ctx -> tmp, bs);
+        moved += cur - j;
+        if ( moved > PARTIAL_INSERTION_LIMIT )
+            return false;
+    }
+    return true;
+}
+
+static void sift_down(u8* base, u64 root, u64 n, const SortCtx* ctx){
+    for(u64 child; (child = 2 * root + 1) < n; root = child){
+        if ( child + 1 < n && LESS(AT(base, child), AT(base, child + 1)) )
+            child++;
+        if ( !LESS(AT(base, root), AT(base, child)) )
+            return;
+        swap(AT(base, root), AT(base, child), ctx -> block_size);
+    }
+}
+
+static void heap_sort(u8* base, u64 n, const SortCtx* ctx){
+    for(u64 i = n / 2; i-- > 0;)
+        sift_down(base, i, n, ctx);
+    for(u64 i = n; i-- > 1;){
+        swap(base, AT(base, i), ctx -> block_size);
+        sift_down(base, 0, i, ctx);
+    }
+}
+
+static void sift_up(u8* base, u64 i, const SortCtx* ctx){
+    while ( i > 0 ){
+        const u64 parent = (i - 1) / 2;
+        if ( !LESS(AT(base, parent), AT(base, i)) )
+            return;
+        swap(AT(base, parent), AT(base, i), ctx -> block_size);
+        i = parent;
+    }
+}
+
+// keeps heap[0, *n) a max heap of the (at most k > 0) smallest elements it
+// was offered, the root is the one the next better element evicts
+static void heap_offer(u8* heap, u64* n, u64 k, const u8* x, const SortCtx* ctx){
+    if ( *n < k ){
+        memcpy(AT(heap, *n), x, ctx -> block_size);
+        sift_up(heap, (*n)++, ctx);
+    }
+    else if ( LESS(x, heap) ){
+        memcpy(heap, x, ctx -> block_size);
+        sift_down(heap, 0, *n, ctx);
+    }
+}
+
+// the pivot sits at base[0], elements strictly smaller end up on its left
+// returns the final pivot position and whether no swap was needed
+static u64 partition_right(u8* base, u64 n, bool* already_partitioned, const SortCtx* ctx){
+    u8* const pivot = base;
+    u64 first = 0, last = n;
+
+    // median selection guarantees an element >= pivot on the right
+    while ( LESS(AT(base, ++first), pivot) );
+    if ( first == 1 )
+        while ( first < last && !LESS(AT(base, --last), pivot) );
+    else
+        while ( !LESS(AT(base, --last), pivot) );
+
+    *already_partitioned = first >= last;
+    while ( first < last ){
+        swap(AT(base, first), AT(base, last), ctx -> block_size);
+        while ( LESS(AT(base, ++first), pivot) );
+        while ( !LESS(AT(base, --last), pivot) );
+    }
+    const u64 pivot_pos = first - 1;
+    swap(base, AT(base, pivot_pos), ctx -> block_size);
+    return pivot_pos;
+}
+
+// elements equal to the pivot end up on its left, used when the range is known
+// to be preceded by an element equal to the pivot (runs of duplicates)
+static u64 partition_left(u8* base, u64 n, const SortCtx* ctx){
+    u8* const pivot = base;
+    u64 first = 0, last = n;
+
+    while ( LESS(pivot, AT(base, --last)) );
+    if ( last + 1 == n )
+        while ( first < last && !LESS(pivot, AT(base, ++first)) );
+    else
+        while ( !LESS(pivot, AT(base, ++first)) );
+
+    while ( first < last ){
+        swap(AT(base, first), AT(base, last), ctx -> block_size);
+        while ( LESS(pivot, AT(base, --last)) );
+        while ( !LESS(pivot, AT(base, ++first)) );
+    }
+    swap(base, AT(base, last), ctx -> block_size);
+    return last;
+}
+
+// swaps a few elements around to break the pattern that produced a bad split
+static inline void break_patterns(u8* base, u64 n, const SortCtx* ctx){
+    if ( n < INSERTION_SORT_THRESHOLD )
+        return;
+    const u32  bs = ctx -> block_size;
+    const u64 q  = n / 4;
+    swap(base, AT(base, q), bs);
+    swap(AT(base, n - 1), AT(base, n - q), bs);
+    if ( n > NINTHER_THRESHOLD ){
+        swap(AT(base, 1), AT(base, q + 1), bs);
+        swap(AT(base, 2), AT(base, q + 2), bs);
+        swap(AT(base, n - 2), AT(base, n - (q + 1)), bs);
+        swap(AT(base, n - 3), AT(base, n - (q + 2)), bs);
+    }
+}
+
+static void pdq_sort(u8* base, u64 n, const SortCtx* ctx){
+    struct { u8* base; u64 n; u32 bad_allowed; bool leftmost; } stack[64];
+    u32  top = 0;
+    u32  bad_allowed = 64 - __builtin_clzll(n | 1);
+    bool leftmost = true;
+
+    for(;;){
+        while ( n > INSERTION_SORT_THRESHOLD ){
+            const u64 half = n / 2;
+            if ( n > NINTHER_THRESHOLD ){
+                sort3(base, AT(base, half), AT(base, n - 1), ctx);
+                sort3(AT(base, 1), AT(base, half - 1), AT(base, n - 2), ctx);
+                sort3(AT(base, 2), AT(base, half + 1), AT(base, n - 3), ctx);
+                sort3(AT(base, half - 1), AT(base, half), AT(base, half + 1), ctx);
+                swap(base, AT(base, half), ctx -> block_size);
+            }
+            else
+                sort3(AT(base, half), base, AT(base, n - 1), ctx);
+
+            // the predecessor is <= everything in the range, if it is not less
+            // than the pivot every element equal to the pivot can be skipped
+            if ( !leftmost && !LESS(base - ctx -> block_size, base) ){
+                const u64 pivot_pos = partition_left(base, n, ctx);
+                base = AT(base, pivot_pos + 1);
+                n   -= pivot_pos + 1;
+                continue;
+            }
+
+            bool already_partitioned;
+            const u64 pivot_pos = partition_right(base, n, &already_partitioned, ctx);
+            u8* const right     = AT(base, pivot_pos + 1);
+            const u64 l_size    = pivot_pos;
+            const u64 r_size    = n - pivot_pos - 1;
+
+            if ( l_size < n / 8 || r_size < n / 8 ){
+                if ( bad_allowed-- == 0 ){
+                    heap_sort(base, n, ctx);
+                    n = 0;
+                    break;
+                }
+                break_patterns(base, l_size, ctx);
+                break_patterns(right, r_size, ctx);
+            }
+            else if ( already_partitioned
+                && partial_insertion_sort(base, l_size, ctx)
+                && partial_insertion_sort(right, r_size, ctx) ){
+                n = 0;
+                break;
+            }
+
+            // keep the larger side for later, the stack never exceeds log2(n)
+            if ( l_size < r_size ){
+                stack[top].base = right; stack[top].n = r_size;
+                stack[top].bad_allowed = bad_allowed; stack[top++].leftmost = false;
+                n = l_size;
+            } else {
+                stack[top].base = base; stack[top].n = l_size;
+                stack[top].bad_allowed = bad_allowed; stack[top++].leftmost = leftmost;
+                base = right; n = r_size; leftmost = false;
+            }
+        }
+        insertion_sort(base, n, ctx);
+        if ( top == 0 )
+            return;
+        top--;
+        base = stack[top].base; n = stack[top].n;
+        bad_allowed = stack[top].bad_allowed; leftmost = stack[top].leftmost;
+    }
+}
+
+// introselect: pdq_sort's partitioning, but only the side holding nth goes
+// on. a run of bad splits finishes the range with heap_sort instead
+static void quick_select(u8* base, u64 n, u64 nth, const SortCtx* ctx){
+    u32  bad_allowed = 64 - __builtin_clzll(n | 1);
+    bool leftmost = true;
+
+    while ( n > INSERTION_SORT_THRESHOLD ){
+        const u64 half = n / 2;
+        if ( n > NINTHER_THRESHOLD ){
+            sort3(base, AT(base, half), AT(base, n - 1), ctx);
+            sort3(AT(base, 1), AT(base, half - 1), AT(base, n - 2), ctx);
+            sort3(AT(base, 2), AT(base, half + 1), AT(base, n - 3), ctx);
+            sort3(AT(base, half - 1), AT(base, half), AT(base, half + 1), ctx);
+            swap(base, AT(base, half), ctx -> block_size);
+        }
+        else
+            sort3(AT(base, half), base, AT(base, n - 1), ctx);
+
+        // everything partition_left puts left of the pivot equals it
+        if ( !leftmost && !LESS(base - ctx -> block_size, base) ){
+            const u64 pivot_pos = partition_left(base, n, ctx);
+            if ( nth <= pivot_pos )
+                return;
+            base = AT(base, pivot_pos + 1);
+            nth -= pivot_pos + 1;
+            n   -= pivot_pos + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        const u64 pivot_pos = partition_right(base, n, &already_partitioned, ctx);
+        const u64 l_size    = pivot_pos;
+        const u64 r_size    = n - pivot_pos - 1;
+        if ( nth == pivot_pos )
+            return;
+        if ( l_size < n / 8 || r_size < n / 8 ){
+            if ( bad_allowed-- == 0 ){
+                heap_sort(base, n, ctx);
+                return;
+            }
+            break_patterns(base, l_size, ctx);
+            break_patterns(AT(base, pivot_pos + 1), r_size, ctx);
+        }
+        if ( nth < pivot_pos )
+            n = l_size;
+        else {
+            base = AT(base, pivot_pos + 1);
+            nth -= pivot_pos + 1;
+            n    = r_size;
+            leftmost = false;
+        }
+    }
+    insertion_sort(base, n, ctx);
+}
+
+// stable merge of a[0, na) and b[0, nb) into dst, ties are taken from a
+static void merge_runs(u8* dst, const u8* a, u64 na, const u8* b, u64 nb, const SortCtx* ctx){
+    const u32 bs = ctx -> block_size;
+    u64 i = 0, j = 0;
+    while ( i < na && j < nb ){
+        if ( LESS(AT(b, j), AT(a, i)) )
+            memcpy(dst, AT(b, j++), bs);
+        else
+            memcpy(dst, AT(a, i++), bs);
+        dst += bs;
+    }
+    memcpy(dst, AT(a, i), (na - i) * bs);
+    memcpy(dst + (na - i) * bs, AT(b, j), (nb - j) * bs);
+}
+
+// bottom-up merge sort, insertion sorted runs are merged back and forth
+// between the data and a scratch buffer of the same size
+static void merge_sort(u8* base, u64 n, u8* scratch, const SortCtx* ctx){
+    const u32  bs  = ctx -> block_size;
+    const u64 run = 16;
+    for(u64 i = 0; i < n; i += run)
+        insertion_sort(AT(base, i), n - i < run ? n - i : run, ctx);
+
+    u8* src = base;
+    u8* dst = scratch;
+    for(u64 width = run; width < n; width *= 2){
+        for(u64 lo = 0; lo < n; lo += 2 * width){
+            const u64 mid = lo + width < n ? lo + width : n;
+            const u64 hi  = mid + width < n ? mid + width : n;
+            merge_runs(AT(dst, lo), AT(src, lo), mid - lo, AT(src, mid), hi - mid, ctx);
+        }
+        u8* t = src; src = dst; dst = t;
+    }
+    if ( src != base )
+        memcpy(base, src, n * bs);
+}
+
+// number of elements of a in the first k elements of the stable merge of a and b
+static u64 merge_corank(u64 k, const u8* a, u64 na, const u8* b, u64 nb, const SortCtx* ctx){
+    u64 lo = k > nb ? k - nb : 0;
+    u64 hi = k < na ? k : na;
+    while ( lo < hi ){
+        const u64 i = lo + (hi - lo) / 2;
+        const u64 j = k - i;
+        if ( j > 0 && i < na && !LESS(AT(b, j - 1), AT(a, i)) )
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+#undef AT
+#undef LESS
+
+// copies input into output (growing it if needed) ahead of an in place sort
+static void sort_prepare(const Vector input, Vector output){
+    handle_err(
+        input == NULL || output == NULL || input -> data == NULL || output -> data == NULL,
+        "Error in sort method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        input -> block_size != output -> block_size,
+        "unresolvable difference in datatypes of input, output of sort ! aboring ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(input);
+    reserve_for(output, input -> size);
+    if ( input != output )
+        memcpy(output -> data, input -> data, input -> block_size * input -> size);
+    output -> size = input -> size;
+    // the sorts return early on these, nothing is left to reorder
+    index_stale(output);
+    if ( output -> size <= 1 )
+        index_settle(output);
+}
+
+// the one element of scratch a sort needs, on the stack unless the blocks are large
+#define SORT_STACK_TMP  256
+
+static inline u8* sort_tmp(const u32 block_size, u8* stack_tmp){
+    if ( LIKELY(block_size <= SORT_STACK_TMP) )
+        return stack_tmp;
+    u8* tmp = (u8*)malloc(block_size);
+    handle_err(
+        tmp == NULL,
+        "Error allocating the scratch element of sort ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    return tmp;
+}
+
+static inline void sort_tmp_free(u8* tmp, u8* stack_tmp){
+    if ( tmp != stack_tmp )
+        free(tmp);
+}
+
+// Public sorting function
+void vec_sort(const Vector input, Vector output, int (*cmp)(void*, void*)) {
+    sort_prepare(input, output);
+    if ( output -> size <= 1 )
+        return;
+    u8 stack_tmp[SORT_STACK_TMP];
+    const SortCtx ctx = { output -> block_size, cmp, sort_tmp(output -> block_size, stack_tmp) };
+    STAT_CMP_BEGIN();
+    pdq_sort(output -> data, output -> size, &ctx);
+    STAT_CMP_END(output);
+    sort_tmp_free(ctx.tmp, stack_tmp);
+    index_settle(output);
+}
+
+void vec_stable_sort(const Vector input, Vector output, int (*cmp)(void*, void*)) {
+    sort_prepare(input, output);
+    if ( output -> size <= 1 )
+        return;
+    u8 stack_tmp[SORT_STACK_TMP];
+    const SortCtx ctx = { output -> block_size, cmp, sort_tmp(output -> block_size, stack_tmp) };
+    u8* scratch = (u8*)malloc(output -> size * output -> block_size);
+    handle_err(
+        scratch == NULL,
+        "Error allocating the scratch buffer of stable sort ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    STAT_CMP_BEGIN();
+    merge_sort(output -> data, output -> size, scratch, &ctx);
+    STAT_CMP_END(output);
+    free(scratch);
+    sort_tmp_free(ctx.tmp, stack_tmp);
+    index_settle(output);
+}
+
+void vec_nth_element(Vector v, u64 nth, int (*cmp)(void*, void*)){
+    handle_err(
+        v -> data == NULL,
+        "Error in nth element method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(v);
+    handle_err(
+        nth >= v -> size,
+        "Error in nth element method ! index out of bounds, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(v);
+    index_stale(v);
+    u8 stack_tmp[SORT_STACK_TMP];
+    const SortCtx ctx = { v -> block_size, cmp, sort_tmp(v -> block_size, stack_tmp) };
+    STAT_CMP_BEGIN();
+    quick_select(v -> data, v -> size, nth, &ctx);
+    STAT_CMP_END(v);
+    sort_tmp_free(ctx.tmp, stack_tmp);
+    index_settle(v);
+}
+
+// in place it is a selection followed by a sort of the first k elements, into
+// another vector the input is streamed through a heap of k elements and only
+// output has to hold them
+void vec_partial_sort(const Vector input, Vector output, u64 k, int (*cmp)(void*, void*)){
+    handle_err(
+        input -> data == NULL || output -> data == NULL,
+        "Error in partial sort method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        input -> block_size != output -> block_size,
+        "unresolvable difference in datatypes of input, output of partial sort ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(output);
+    if ( k > input -> size )
+        k = input -> size;
+    close_gap(input);
+    close_gap(output);
+    index_stale(output);
+    u8 stack_tmp[SORT_STACK_TMP];
+    const SortCtx ctx = { output -> block_size, cmp, sort_tmp(output -> block_size, stack_tmp) };
+    STAT_CMP_BEGIN();
+    if ( input == output ){
+        if ( k < output -> size )
+            quick_select(output -> data, output -> size, k, &ctx);
+        pdq_sort(output -> data, k, &ctx);
+        output -> size = k;
+    }
+    else {
+        output -> size = 0;
+        reserve_for(output, k);
+        const u32 bs = input -> block_size;
+        for(u64 i = 0; k != 0 && i < input -> size; i++)
+            heap_offer(output -> data, &output -> size, k, input -> data + i * bs, &ctx);
+        heap_sort(output -> data, output -> size, &ctx);
+    }
+    STAT_CMP_END(output);
+    sort_tmp_free(ctx.tmp, stack_tmp);
+    index_settle(output);
+}
+
+void vec_topk_push(Vector heap, void* x, u64 k, int (*cmp)(void*, void*)){
+    handle_err(
+        heap -> data == NULL,
+        "Error in top k method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(heap);
+    if ( UNLIKELY(k == 0) )
+        return;
+    close_gap(heap);
+    index_stale(heap);
+    if ( heap -> size < k && heap -> size == heap -> capacity )
+        reserve_for(heap, heap -> size + 1);
+    const SortCtx ctx = { heap -> block_size, cmp, NULL };
+    STAT_CMP_BEGIN();
+    heap_offer(heap -> data, &heap -> size, k, (const u8*)x, &ctx);
+    STAT_CMP_END(heap);
+    index_settle(heap);
+}
+
+void vec_topk_finish(Vector heap, int (*cmp)(void*, void*)){
+    handle_err(
+        heap -> data == NULL,
+        "Error in top k method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(heap);
+    close_gap(heap);
+    index_stale(heap);
+    const SortCtx ctx = { heap -> block_size, cmp, NULL };
+    STAT_CMP_BEGIN();
+    heap_sort(heap -> data, heap -> size, &ctx);
+    STAT_CMP_END(heap);
+    index_settle(heap);
+}
+
+void vec_radix_sort(const Vector input, Vector output, u64 key_offset, u8 key_width, bool is_signed){
+    sort_prepare(input, output);
+    handle_err(
+        key_width == 0 || key_width > 8 || key_offset + key_width > output -> block_size,
+        "Error in radix sort method ! the key does not fit in the element, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    const u64 n  = output -> size;
+    const u32  bs = output -> block_size;
+    if ( n <= 1 )
+        return;
+
+    // keys are little endian, flipping the top bit of a signed key orders
+    // negative values before positive ones
+    u64 counts[8][256] = { 0 };
+    const u8* key = output -> data + key_offset;
+    for(u64 i = 0; i < n; i++, key += bs){
+        for(u8 b = 0; b < key_width; b++)
+            counts[b][key[b]]++;
+    }
+    if ( is_signed ){
+        u64 flipped[256];
+        for(u32 d = 0; d < 256; d++)
+            flipped[d] = counts[key_width - 1][d ^ 0x80];
+        memcpy(counts[key_width - 1], flipped, sizeof(flipped));
+    }
+
+    u64 scratch_bytes = n * bs;
+    u8* scratch = output -> arena == NULL ?
+        (u8*)malloc(scratch_bytes):
+        arena_alloc(output -> arena, &scratch_bytes);
+    handle_err(
+        scratch == NULL,
+        "Error allocating the scratch buffer of radix sort ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+
+    u8* src = output -> data;
+    u8* dst = scratch;
+    for(u8 b = 0; b < key_width; b++){
+        const u8 flip = is_signed && b == key_width - 1 ? 0x80 : 0;
+        // every element shares this digit, the pass would be a plain copy
+        if ( counts[b][src[key_offset + b] ^ flip] == n )
+            continue;
+        u64 offsets[256];
+        u64 sum = 0;
+        for(u32 d = 0; d < 256; d++){
+            offsets[d] = sum;
+            sum += counts[b][d];
+        }
+        const u8* elem = src;
+        for(u64 i = 0; i < n; i++, elem += bs){
+            const u8 digit = elem[key_offset + b] ^ flip;
+            copy_block(dst + offsets[digit]++ * bs, elem, bs);
+        }
+        u8* t = src; src = dst; dst = t;
+    }
+    if ( src != output -> data )
+        memcpy(output -> data, src, n * bs);
+    if ( output -> arena == NULL )
+        free(scratch);
+    else
+        arena_release(output -> arena, scratch, scratch_bytes);
+    index_settle(output);
+}
+
+// below this many elements vec_sort_parallel just calls vec_sort
+#ifndef VEC_PARALLEL_SORT_THRESHOLD
+    #define VEC_PARALLEL_SORT_THRESHOLD     (1 << 16)
+#endif
+
+// either sorts a[0, na) in place (dst == NULL) or merges a and b into dst
+typedef struct{
+    const SortCtx*  ctx;
+    u8*             dst;
+    u8*             a;
+    u8*             b;
+    u64             na;
+    u64             nb;
+    u64             cmp_calls;              // VEC_STATS, handed back to the caller's thread
+} SortTask;
+
+static void* sort_task(void* arg){
+    SortTask* t = (SortTask*)arg;
+    u8 stack_tmp[SORT_STACK_TMP];
+    const SortCtx ctx = { t -> ctx -> block_size, t -> ctx -> cmp, sort_tmp(t -> ctx -> block_size, stack_tmp) };
+#ifdef VEC_STATS
+    const u64 before = cmp_calls;
+#endif
+    if ( t -> dst == NULL )
+        pdq_sort(t -> a, t -> na, &ctx);
+    else
+        merge_runs(t -> dst, t -> a, t -> na, t -> b, t -> nb, &ctx);
+#ifdef VEC_STATS
+    t -> cmp_calls = cmp_calls - before;
+    cmp_calls = before;
+#endif
+    sort_tmp_free(ctx.tmp, stack_tmp);
+    return NULL;
+}
+
+// runs every task on its own thread (the first one on the caller's), a task
+// whose thread could not be created is run inline instead
+static void run_sort_tasks(SortTask* tasks, u32 count){
+    pthread_t threads[count];
+    bool      started[count];
+    for(u32 i = 1; i < count; i++){
+        started[i] = pthread_create(&threads[i], NULL, sort_task, &tasks[i]) == 0;
+        if ( UNLIKELY(!started[i]) )
+            sort_task(&tasks[i]);
+    }
+    sort_task(&tasks[0]);
+    for(u32 i = 1; i < count; i++)
+        if ( started[i] )
+            pthread_join(threads[i], NULL);
+#ifdef VEC_STATS
+    for(u32 i = 0; i < count; i++)
+        cmp_calls += tasks[i].cmp_calls;
+#endif
+}
+
+void vec_sort_parallel(const Vector input, Vector output, int (*cmp)(void*, void*), u32 nthreads){
+    if ( nthreads == 0 ){
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = online > 0 ? (u32)online : 1;
+    }
+    if ( nthreads > VEC_MAX_THREADS )
+        nthreads = VEC_MAX_THREADS;
+    if ( input -> size < VEC_PARALLEL_SORT_THRESHOLD || nthreads == 1 ){
+        vec_sort(input, output, cmp);
+        return;
+    }
+    sort_prepare(input, output);
+    const u64 n  = output -> size;
+    const u32  bs = output -> block_size;
+    const SortCtx shared = { bs, cmp, NULL };
+    STAT_CMP_BEGIN();
+
+    // every thread sorts its own contiguous run
+    u64      bounds[nthreads + 1];
+    SortTask tasks[nthreads];
+    for(u32 i = 0; i <= nthreads; i++)
+        bounds[i] = n / nthreads * i + (n % nthreads) * i / nthreads;
+    for(u32 i = 0; i < nthreads; i++)
+        tasks[i] = (SortTask){ &shared, NULL, output -> data + bounds[i] * bs, NULL, bounds[i + 1] - bounds[i], 0, 0 };
+    run_sort_tasks(tasks, nthreads);
+
+    u64 scratch_bytes = n * bs;
+    u8* scratch = output -> arena == NULL ?
+        (u8*)malloc(scratch_bytes):
+        arena_alloc(output -> arena, &scratch_bytes);
+    handle_err(
+        scratch == NULL,
+        "Error allocating the scratch buffer of parallel sort ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+
+    // pairs of runs are merged until one is left, each merge is cut into
+    // independent pieces along the merge path so that every thread has work
+    u8* src = output -> data;
+    u8* dst = scratch;
+    for(u32 runs = nthreads; runs > 1;){
+        const u32 pairs    = runs / 2;
+        const u32 per_pair = nthreads / pairs;
+        u32 count = 0;
+        for(u32 p = 0; p < pairs; p++){
+            const u64 lo  = bounds[2 * p];
+            const u64 mid = bounds[2 * p + 1];
+            const u64 hi  = bounds[2 * p + 2];
+            const u64 total = hi - lo;
+            u8* a = src + lo * bs;
+            u8* b = src + mid * bs;
+            u64 k0 = 0, i0 = 0;
+            for(u32 piece = 1; piece <= per_pair; piece++){
+                const u64 k1 = total / per_pair * piece + (total % per_pair) * piece / per_pair;
+                const u64 i1 = merge_corank(k1, a, mid - lo, b, hi - mid, &shared);
+                tasks[count++] = (SortTask){ &shared, dst + (lo + k0) * bs,
+                    a + i0 * bs, b + (k0 - i0) * bs, i1 - i0, (k1 - i1) - (k0 - i0), 0 };
+                k0 = k1;
+                i0 = i1;
+            }
+        }
+        if ( runs % 2 )
+            memcpy(dst + bounds[runs - 1] * bs, src + bounds[runs - 1] * bs, (n - bounds[runs - 1]) * bs);
+        run_sort_tasks(tasks, count);
+
+        for(u32 p = 0; p < pairs; p++)
+            bounds[p] = bounds[2 * p];
+        if ( runs % 2 )
+            bounds[pairs] = bounds[runs - 1];
+        runs = pairs + runs % 2;
+        bounds[runs] = n;
+        u8* t = src; src = dst; dst = t;
+    }
+    if ( src != output -> data )
+        memcpy(output -> data, src, n * bs);
+    if ( output -> arena == NULL )
+        free(scratch);
+    else
+        arena_release(output -> arena, scratch, scratch_bytes);
+    STAT_CMP_END(output);
+    index_settle(output);
+}
+
+// merge and set algebra on sorted vectors: one walk over both inputs with
+// the semantics of the std:: algorithms (duplicates are counted). when one
+// input is GALLOP_RATIO times longer than the other, its runs are skipped
+// with exponential searches instead of one comparison per element
+#define GALLOP_RATIO    16
+
+enum{ SET_MERGE, SET_UNION, SET_INTERSECTION, SET_DIFFERENCE, SET_INCLUDES };
+
+// index of the first element of data[from, n) not less than x (greater than
+// x when upper), probing from + 1, 3, 7 ... ahead before bisecting
+static u64 gallop(const u8* data, u64 from, u64 n, const u32 bs, const void* x,
+        int (*cmp)(void*, void*), const bool upper){
+    u64 lo = from, hi = from, step = 1;
+    while ( hi < n ){
+        const int c = CMP(cmp, (void*)(data + hi * bs), (void*)x);
+        if ( upper ? c > 0 : c >= 0 )
+            break;
+        lo   = hi + 1;
+        hi  += step;
+        step *= 2;
+    }
+    if ( hi > n )
+        hi = n;
+    return lo + bound_search(data + lo * bs, hi - lo, bs, (void*)x, cmp, upper);
+}
+
+static inline void set_emit(Vector out, const u8* src, u64 count){
+    memcpy(out -> data + out -> size * out -> block_size, src, count * out -> block_size);
+    out -> size += count;
+}
+
+static void set_check(const Vector a, const Vector b, const Vector out){
+    handle_err(
+        a -> data == NULL || b -> data == NULL || (out != NULL && out -> data == NULL),
+        "Error in set method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        a -> block_size != b -> block_size || (out != NULL && out -> block_size != a -> block_size),
+        "unresolvable difference in datatypes of the inputs and output of set method ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        out == a || out == b,
+        "Error in set method ! the output cannot be one of the inputs, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+}
+
+// out is sized once for the longest possible result and written in place,
+// returns false only when an SET_INCLUDES walk found an element of b missing from a
+static bool set_walk(const Vector a, const Vector b, Vector out, int (*cmp)(void*, void*), const int op){
+    set_check(a, b, out);
+    close_gap(a);
+    close_gap(b);
+    const u64 na = a -> size, nb = b -> size;
+    const u32 bs = a -> block_size;
+    if ( out != NULL ){
+        close_gap(out);
+        index_stale(out);
+        out -> size = 0;
+        reserve_for(out,
+            op == SET_INTERSECTION ? (na < nb ? na : nb) :
+            op == SET_DIFFERENCE   ? na : na + nb);
+    }
+    const bool gallop_a = na > GALLOP_RATIO * nb;
+    const bool gallop_b = nb > GALLOP_RATIO * na;
+    const bool keep_a   = op == SET_MERGE || op == SET_UNION || op == SET_DIFFERENCE;
+    const bool keep_b   = op == SET_MERGE || op == SET_UNION;
+    STAT_CMP_BEGIN();
+    u64 i = 0, j = 0;
+    while ( i < na && j < nb ){
+        const u8* x = a -> data + i * bs;
+        const u8* y = b -> data + j * bs;
+        if ( gallop_a ){
+            // merge takes the ties from a first
+            const u64 k = gallop(a -> data, i, na, bs, y, cmp, op == SET_MERGE);
+            if ( keep_a )
+                set_emit(out, x, k - i);
+            i = k;
+            if ( i == na )
+                break;
+            x = a -> data + i * bs;
+        }
+        else if ( gallop_b ){
+            const u64 k = gallop(b -> data, j, nb, bs, x, cmp, false);
+            if ( op == SET_INCLUDES && k != j ){
+                STAT_CMP_END(a);
+                return false;
+            }
+            if ( keep_b )
+                set_emit(out, y, k - j);
+            j = k;
+            if ( j == nb )
+                break;
+            y = b -> data + j * bs;
+        }
+        const int c = CMP(cmp, (void*)x, (void*)y);
+        if ( op == SET_MERGE ){
+            if ( c <= 0 )
+                set_emit(out, x, 1), i++;
+            else
+                set_emit(out, y, 1), j++;
+        }
+        else if ( c < 0 ){
+            if ( keep_a )
+                set_emit(out, x, 1);
+            i++;
+        }
+        else if ( c > 0 ){
+            if ( op == SET_INCLUDES ){
+                STAT_CMP_END(a);
+                return false;
+            }
+            if ( keep_b )
+                set_emit(out, y, 1);
+            j++;
+        }
+        else{
+            if ( op == SET_UNION || op == SET_INTERSECTION )
+                set_emit(out, x, 1);
+            i++, j++;
+        }
+    }
+    STAT_CMP_END(a);
+    if ( keep_a && i < na )
+        set_emit(out, a -> data + i * bs, na - i);
+    if ( keep_b && j < nb )
+        set_emit(out, b -> data + j * bs, nb - j);
+    if ( out != NULL )
+        index_settle(out);
+    return op != SET_INCLUDES || j == nb;
+}
+
+void vec_merge(const Vector a, const Vector b, Vector out, int (*cmp)(void*, void*)){
+    set_walk(a, b, out, cmp, SET_MERGE);
+}
+
+u64 vec_set_union(const Vector a, const Vector b, Vector out, int (*cmp)(void*, void*)){
+    set_walk(a, b, out, cmp, SET_UNION);
+    return out -> size;
+}
+
+u64 vec_set_intersection(const Vector a, const Vector b, Vector out, int (*cmp)(void*, void*)){
+    set_walk(a, b, out, cmp, SET_INTERSECTION);
+    return out -> size;
+}
+
+u64 vec_set_difference(const Vector a, const Vector b, Vector out, int (*cmp)(void*, void*)){
+    set_walk(a, b, out, cmp, SET_DIFFERENCE);
+    return out -> size;
+}
+
+bool vec_includes(const Vector a, const Vector b, int (*cmp)(void*, void*)){
+    return set_walk(a, b, NULL, cmp, SET_INCLUDES);
+}
+
+// merged from the back into the grown buffer, so the elements of v below the
+// smallest new one never move and the others move exactly once. a small batch
+// finds each of its insertion points by bisection and moves whole runs
+void vec_insert_sorted_batch(Vector v, Vector batch, int (*cmp)(void*, void*)){
+    set_check(v, batch, NULL);
+    handle_err(
+        v == batch,
+        "Error in insert sorted batch method ! the batch cannot be the vector itself, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    if ( UNLIKELY(batch -> size == 0) )
+        return;
+    vec_sort(batch, batch, cmp);
+    const u64 n = v -> size, m = batch -> size;
+    const u32 bs = v -> block_size;
+    reserve_for(v, n + m);
+    index_stale(v);
+    STAT_CMP_BEGIN();
+    u8* const data = v -> data;
+    const u8* const add = batch -> data;
+    u64 i = n, j = m;
+    if ( n > GALLOP_RATIO * m ){
+        while ( j > 0 ){
+            // new elements go after the equal ones already there
+            const u64 p = bound_search(data, i, bs, (void*)(add + (j - 1) * bs), cmp, true);
+            memmove(data + (p + j) * bs, data + p * bs, (i - p) * bs);
+            STAT_ADD(v, moved_bytes, (i - p) * bs);
+            memcpy(data + (p + j - 1) * bs, add + (j - 1) * bs, bs);
+            i = p;
+            j--;
+        }
+    }
+    else{
+        while ( j > 0 ){
+            if ( i > 0 && CMP(cmp, (void*)(add + (j - 1) * bs), (void*)(data + (i - 1) * bs)) < 0 ){
+                copy_block(data + (i + j - 1) * bs, data + (i - 1) * bs, bs);
+                i--;
+            }
+            else{
+                copy_block(data + (i + j - 1) * bs, add + (j - 1) * bs, bs);
+                j--;
+            }
+        }
+        STAT_ADD(v, moved_bytes, (n - i) * bs);
+    }
+    STAT_CMP_END(v);
+    v -> size = n + m;
+    index_settle(v);
+}
+
+// compaction: the remove functions walk v once, every run of kept elements
+// is slid down with one memmove and every run of dropped ones is appended to
+// removed (when not NULL). nothing at or past the write position has been
+// overwritten yet, so the walk keeps reading the original elements
+static void compact_begin(Vector v, Vector removed){
+    handle_err(
+        v -> data == NULL || (removed != NULL && removed -> data == NULL),
+        "Error in remove method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    check_writable(v);
+    handle_err(
+        removed != NULL && (removed == v || removed -> block_size != v -> block_size),
+        "unresolvable difference in datatypes of the vector and the removed elements ! aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(v);
+    index_stale(v);
+    if ( removed != NULL ){
+        close_gap(removed);
+        index_stale(removed);
+        removed -> size = 0;
+    }
+}
+
+static inline void compact_keep(Vector v, u64* write, u64 from, u64 to){
+    if ( *write != from && to > from ){
+        memmove(v -> data + *write * v -> block_size, v -> data + from * v -> block_size,
+            (to - from) * v -> block_size);
+        STAT_ADD(v, moved_bytes, (to - from) * v -> block_size);
+    }
+    *write += to - from;
+}
+
+static inline void compact_drop(const Vector v, Vector removed, u64 from, u64 to){
+    if ( removed == NULL || to == from )
+        return;
+    reserve_for(removed, removed -> size + to - from);
+    set_emit(removed, v -> data + from * v -> block_size, to - from);
+}
+
+static u64 compact_end(Vector v, Vector removed, u64 write, bool fit){
+    const u64 gone = v -> size - write;
+    v -> size = write;
+    index_settle(v);
+    if ( removed != NULL )
+        index_settle(removed);
+    if ( fit )
+        vec_fit(v);
+    return gone;
+}
+
+u64 vec_remove_if(Vector v, bool (*pred)(const void* x, void* ctx), void* ctx, Vector removed, bool fit){
+    compact_begin(v, removed);
+    const u64 n  = v -> size;
+    const u32 bs = v -> block_size;
+    // a run ends on the first element of the other kind, its verdict is
+    // carried into the next run so pred sees every element exactly once
+    u64 w = 0, i = 0;
+    bool drop = n != 0 && pred(v -> data, ctx);
+    while ( i < n ){
+        u64 j = i + 1;
+        bool next = drop;
+        while ( j < n && (next = pred(v -> data + j * bs, ctx)) == drop )
+            j++;
+        if ( drop )
+            compact_drop(v, removed, i, j);
+        else
+            compact_keep(v, &w, i, j);
+        drop = next;
+        i = j;
+    }
+    return compact_end(v, removed, w, fit);
+}
+
+// the kept runs are found by the simd scan of vec_in
+u64 vec_remove_value(Vector v, void* x, Vector removed, bool fit){
+    compact_begin(v, removed);
+    const u64 n  = v -> size;
+    const u32 bs = v -> block_size;
+    // x may well point into v, which is about to be overwritten
+    u8 stack_tmp[SORT_STACK_TMP];
+    u8* value = sort_tmp(bs, stack_tmp);
+    memcpy(value, x, bs);
+    const VecView all = as_view(v);
+    u64 w = 0, i = 0;
+    while ( i < n ){
+        u64 j = scan_find(all, value, i);
+        compact_keep(v, &w, i, j);
+        for(i = j; j < n && memcmp(v -> data + j * bs, value, bs) == 0; j++);
+        compact_drop(v, removed, i, j);
+        i = j;
+    }
+    sort_tmp_free(value, stack_tmp);
+    return compact_end(v, removed, w, fit);
+}
+
+u64 vec_unique(Vector v, int (*cmp)(void*, void*), Vector removed, bool fit){
+    compact_begin(v, removed);
+    const u64 n  = v -> size;
+    const u32 bs = v -> block_size;
+    if ( n == 0 )
+        return compact_end(v, removed, 0, fit);
+    STAT_CMP_BEGIN();
+    // same walk as vec_remove_if, every neighbouring pair is compared once
+    u64 w = 1, i = 1;
+    bool dup = n > 1 && CMP(cmp, v -> data, v -> data + bs) == 0;
+    while ( i < n ){
+        u64 j = i + 1;
+        bool next = dup;
+        while ( j < n && (next = CMP(cmp, v -> data + (j - 1) * bs, v -> data + j * bs) == 0) == dup )
+            j++;
+        if ( dup )
+            compact_drop(v, removed, i, j);
+        else
+            compact_keep(v, &w, i, j);
+        dup = next;
+        i = j;
+    }
+    STAT_CMP_END(v);
+    return compact_end(v, removed, w, fit);
+}
+
+// the end of every run of equal elements is galloped to, a long run costs
+// a logarithmic number of comparisons and distinct elements one each
+u64 vec_dedup_sorted(Vector v, int (*cmp)(void*, void*), Vector removed, bool fit){
+    compact_begin(v, removed);
+    const u64 n  = v -> size;
+    const u32 bs = v -> block_size;
+    STAT_CMP_BEGIN();
+    u64 w = 0, run = 0, i = 0;
+    while ( i < n ){
+        const u64 end = gallop(v -> data, i + 1, n, bs, v -> data + i * bs, cmp, true);
+        if ( end > i + 1 ){
+            compact_keep(v, &w, run, i + 1);
+            compact_drop(v, removed, i + 1, end);
+            run = end;
+        }
+        i = end;
+    }
+    compact_keep(v, &w, run, n);
+    STAT_CMP_END(v);
+    return compact_end(v, removed, w, fit);
+}
+
+void vec_slice(const Vector input, Vector output, const u64 low, const u64 high){
+    handle_err(
+        input == NULL || output == NULL || input -> data == NULL || output -> data == NULL,
+        "Error in slice method ! a null vector was passed, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    handle_err(
+        input -> block_size != output -> block_size,
+        "unresolvable difference in datatypes of input, output of slice ! aboring ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    memcpy(v -> data + v -> block_size * index, x, v -> block_size);
+
+    check_writable(output);
+    close_gap(input);
+    close_gap(output);
+    u64 len = high - low;
+    if ( output -> capacity < len)
+        set_capacity(output, len);
+    output -> size = len;
+    memcpy(output -> data, input -> data + low * input -> block_size, input -> block_size * len);
+    index_refresh(output);
 }
 
-void vec_remove_(Vector v, u64 index, void* gottem){
-    handle_err(
-        v == NULL || v -> data == NULL,
-        "Error removing into a null vector! aborting now ...",
-        cleanup();
-        exit(EXIT_FAILURE);
-    )
+void vec_fit(Vector v){
+#ifdef __linux__
+    if ( v -> reserved != 0 ){
+        // keep the address space, hand the unused pages back to the kernel
+        const u64 head = (u64)(v -> data - v -> base);
+        const u64 used = v -> size == 0 && head == 0 ? 0 : page_round(head + v -> size * v -> block_size);
+        if ( used < v -> reserved )
+            madvise(v -> base + used, v -> reserved - used, MADV_DONTNEED);
+        return;
+    }
+#endif
+    set_capacity(v, v -> size);
+}
+
+void vec_set_growth(Vector v, u8 policy, u64 step){
     handle_err(
-        index >= v -> size,
-        "Error removing into the vector! index out of bounds, aborting now ...",
+        policy > VEC_GROW_LINEAR || (policy == VEC_GROW_LINEAR && step == 0),
+        "Error invalid growth policy for the Vector! aborting now ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    memcpy(
-        gottem,
-        v -> data + v -> block_size * index,
-        v -> block_size
-    );
-    memmove(
-       v -> data + index * v -> block_size,
-       v -> data + (index + 1) * v -> block_size,
-       v -> block_size * (v -> size - index - 1)
-    );
-    v -> size --;
-   
+    v -> growth    = policy;
+    v -> grow_step = step;
+    v -> grow      = NULL;
 }
 
-bool vec_empty(const Vector v){ return v -> size == 0; }
+void vec_set_growth_fn(Vector v, u64 (*grow)(u64 capacity, u64 needed)){
+    v -> growth = VEC_GROW_CUSTOM;
+    v -> grow   = grow;
+}
 
-u64  vec_len(const Vector v) { return v -> size; }
+void vec_setcapacity(Vector v, u64 capa){
+    if ( capa < v -> size)
+        return;
+    set_capacity(v, capa);
+}
 
-void vec_reverse(Vector src, Vector dest){
+u64 vec_capacity(const Vector v){
     handle_err(
-        src == NULL || dest == NULL || src -> data == NULL || dest -> data == NULL,
-        "Error in reverse method ! a null vector was passed, aborting now ...",
+        v == NULL || v -> data == NULL,
+        "Error getting capacity for the null Vector! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
+    return v -> capacity;
+}
+
+u32 vec_blocksize(const Vector v){
     handle_err(
-        src -> block_size != dest -> block_size,
-        "unresolvable difference in datatypes of source and destination of reverse ! aboring ...",
+        v == NULL || v -> data == NULL,
+        "Error getting datasize for the null Vector! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-   
-    const u64 orig_size = src -> size;
-
-    if ( UNLIKELY(src -> size == 0))
-        return;
-
-    if ( dest -> capacity < src -> size )
-        dest -> capacity = src -> size; 
+    return v -> block_size;
+}
 
-    u8 tmp_arr[orig_size * src -> block_size];
-    u8 x[src -> block_size];
+void vec_stats(const Vector v, VecStats* stats){
+#ifdef VEC_STATS
+    *stats = v -> stats;
+    if ( stats -> peak_capacity < v -> capacity )
+        stats -> peak_capacity = v -> capacity;
+#else
+    (void)v;
+    *stats = (VecStats){ 0 };
+#endif
+}
 
-    for(u64 i = 0; i < orig_size; i++){
-        vec_get_(src, i, x);
-        memcpy(tmp_arr + (orig_size - 1 - i) * src -> block_size, x, src -> block_size); 
+void vec_stats_dump(void){
+#ifdef VEC_STATS
+    pthread_mutex_lock(&live_lock);
+    for(Vector v = live_head; v != NULL; v = v -> live_next){
+        VecStats s;
+        vec_stats(v, &s);
+        fprintf(stderr,
+            "vector %p: %llu x %u bytes (capacity %llu, peak %llu), %llu grows, "
+            "%llu bytes reallocated, %llu bytes moved, %llu comparisons\n",
+            (void*)v, (unsigned long long)v -> size, v -> block_size,
+            (unsigned long long)v -> capacity, (unsigned long long)s.peak_capacity,
+            (unsigned long long)s.grows, (unsigned long long)s.realloc_bytes,
+            (unsigned long long)s.moved_bytes, (unsigned long long)s.cmp_calls);
     }
-    memmove(dest -> data, tmp_arr, orig_size * src -> block_size);
-    dest -> size = orig_size;
+    pthread_mutex_unlock(&live_lock);
+#endif
 }
 
-void vec_join(Vector appendee, const Vector appended){
-     handle_err(
-        appendee == NULL || appended == NULL || appendee -> data == NULL || appended -> data == NULL,
-        "Error in joining method ! a null vector was passed, aborting now ...",
+void vec_stats_forget(Vector v){
+    live_unlink(v);
+    (void)v;
+}
+
+// a source overlapping the buffer of v moves or goes away when v grows,
+// shifts its elements or closes its gap, it is copied out first. NULL when
+// it lies elsewhere and can be read in place
+static u8* detach_source(const Vector v, const void* src, u64 bytes){
+    const u8* p = (const u8*)src;
+    if ( LIKELY(p >= v -> data + v -> capacity * v -> block_size || p + bytes <= v -> data) )
+        return NULL;
+    u8* copy = (u8*)malloc(bytes);
+    handle_err(
+        copy == NULL,
+        "Error Allocating Space for the Vector! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
+    memcpy(copy, p, bytes);
+    return copy;
+}
+
+void vec_push_n(Vector v, void* x, u64 n){
     handle_err(
-        appendee -> block_size != appended -> block_size,
-        "unresolvable difference in datatypes of source and destination of join ! aborting ...",
+        v == NULL || v -> data == NULL,
+        "Null Vector passed as a parameter to push to ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    u64 capacity_cap = appendee -> size + appended -> size;
-    if ( appendee -> capacity < capacity_cap ){
-        const u64 old_capa = appendee -> capacity;
-        appendee -> data = appendee -> arena == NULL ?
-            ds_realloc(appendee -> data, appendee -> block_size * (appendee -> size + appended -> size)):
-            realloc_on_arena(appendee -> arena, appendee -> data, old_capa * appendee -> block_size, appendee -> block_size * (appendee -> size + appended -> size));
-        appendee -> capacity = capacity_cap;    
+    if ( UNLIKELY(n == 0) )
+        return;
+    u8* own = detach_source(v, x, v -> block_size);
+    reserve_for(v, v -> size + n);
+    u8* dst = v -> data + v -> size * v -> block_size;
+    memcpy(dst, own != NULL ? own : x, v -> block_size);
+    free(own);
+    // double the filled run each time instead of copying one element at a time
+    u64 filled = 1;
+    while ( filled < n ){
+        const u64 chunk = filled < n - filled ? filled : n - filled;
+        memcpy(dst + filled * v -> block_size, dst, chunk * v -> block_size);
+        filled += chunk;
     }
-    memcpy(appendee -> data + appendee -> size * appendee -> block_size,
-        appended -> data,
-        appended -> size * appendee -> block_size
-    );
-    appendee -> size = capacity_cap;
+    const u64 from = v -> size;
+    v -> size += n;
+    for(u64 i = from; i < v -> size; i++)
+        index_add(v, i);
 }
 
-bool vec_in(const Vector v, void* x){
+void vec_extend_from(Vector v, const void* arr, u64 count){
     handle_err(
         v == NULL || v -> data == NULL,
-        "Error searching in a null vector! aborting now ...",
+        "Null Vector passed as a parameter to extend ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    for(u64 i = 0; i < v -> size; i++)
-        if ( memcmp(v -> data + i * v -> block_size, x, v -> block_size) == 0)
-            return true;
-    
-    return false;
-
+    if ( UNLIKELY(count == 0) )
+        return;
+    u8* own = detach_source(v, arr, count * v -> block_size);
+    if ( own != NULL )
+        arr = own;
+    reserve_for(v, v -> size + count);
+    memcpy(v -> data + v -> size * v -> block_size, arr, count * v -> block_size);
+    free(own);
+    const u64 from = v -> size;
+    v -> size += count;
+    for(u64 i = from; i < v -> size; i++)
+        index_add(v, i);
 }
 
-bool vec_eq(const Vector va, const Vector vb){
+void vec_insert_range(Vector v, const void* arr, u64 count, u64 index){
     handle_err(
-        va == NULL || vb == NULL || va -> data == NULL || vb -> data == NULL,
-        "Error in comparing method ! a null vector was passed, aborting now ...",
+        v == NULL || v -> data == NULL,
+        "Error inserting into a null vector! aborting now ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
     handle_err(
-        va -> block_size != vb -> block_size,
-        "unresolvable difference in datatypes of source and destination of compare ! aborting ...",
+        index > v -> size,
+        "Error inserting into the vector! index out of bounds, aborting now ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    if ( va -> size != vb -> size ) return false;
-    return memcmp(va -> data, vb -> data, va -> size * va -> block_size) == 0;
+    if ( UNLIKELY(count == 0) )
+        return;
+    u8* own = detach_source(v, arr, count * v -> block_size);
+    if ( own != NULL )
+        arr = own;
+    if ( v -> gapped ){
+        if ( v -> capacity - v -> size < count )
+            reserve_for(v, v -> size + count);
+        move_gap(v, index);
+        memcpy(v -> data + index * v -> block_size, arr, count * v -> block_size);
+        v -> gap = index + count;
+        v -> size += count;
+        index_refresh(v);
+        free(own);
+        return;
+    }
+    reserve_for(v, v -> size + count);
+    memmove(v -> data + (index + count) * v -> block_size,
+        v -> data + index * v -> block_size,
+        (v -> size - index) * v -> block_size
+    );
+    STAT_ADD(v, moved_bytes, (v -> size - index) * v -> block_size);
+    memcpy(v -> data + index * v -> block_size, arr, count * v -> block_size);
+    free(own);
+    v -> size += count;
+    index_refresh(v);
 }
 
-void vec_copy(const Vector src, Vector dest){
-     handle_err(
-        src == NULL || dest == NULL || src -> data == NULL || dest -> data == NULL,
-        "Error in copy method ! a null vector was passed, aborting now ...",
+void vec_erase_range(Vector v, u64 low, u64 high, void* gottem){
+    handle_err(
+        v == NULL || v -> data == NULL,
+        "Error removing from a null vector! aborting now ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
+    check_writable(v);
     handle_err(
-        src -> block_size != dest -> block_size,
-        "unresolvable difference in datatypes of source and destination of copy ! aboring ...",
+        low > high || high > v -> size,
+        "Error removing from the vector! range out of bounds, aborting now ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    if ( dest -> capacity < src -> size ){
-        const u64 old_capa = dest -> capacity;
-        dest -> data = dest -> arena == NULL ?
-            ds_realloc(dest -> data, src -> size * src -> block_size):
-            realloc_on_arena(dest -> arena, dest -> data, old_capa * dest -> block_size, src -> size * src -> block_size );
-        dest -> capacity = src -> size;
+    if ( v -> gapped ){
+        move_gap(v, low);
+        if ( gottem != NULL )
+            memcpy(gottem, v -> data + (low + v -> capacity - v -> size) * v -> block_size,
+                (high - low) * v -> block_size);
+        v -> size -= high - low;
+        index_refresh(v);
+        return;
     }
-    memcpy(dest -> data, src -> data, src -> block_size * src -> size );
-    dest -> size = src -> size;
+    if ( gottem != NULL )
+        memcpy(gottem, v -> data + low * v -> block_size, (high - low) * v -> block_size);
+    memmove(v -> data + low * v -> block_size,
+        v -> data + high * v -> block_size,
+        (v -> size - high) * v -> block_size
+    );
+    STAT_ADD(v, moved_bytes, (v -> size - high) * v -> block_size);
+    v -> size -= high - low;
+    index_refresh(v);
 }
 
-void vec_clear(const Vector v){ 
+void vec_reserve(Vector v, u64 n){
     handle_err(
         v == NULL || v -> data == NULL,
-        "Error in clear method ! a null vector was passed, aborting now ...",
+        "Null Vector passed as a parameter to reserve ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    v -> size = 0;
+    reserve_for(v, n);
 }
 
-u64 vec_count(const Vector v, void* x){
+void vec_fail_(const char* msg){
+    fprintf(stderr, "\e[31m%s\e[m\n", msg);
+    cleanup();
+    exit(EXIT_FAILURE);
+}
+
+VecView vec_view(const Vector v, u64 low, u64 high){
     handle_err(
         v == NULL || v -> data == NULL,
-        "Error in count method ! a null vector was passed, aborting now ...",
+        "Error in view method ! a null vector was passed, aborting now ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    u64 occurences = 0;
-    for(u64 i = 0; i < v -> size; i++)
-        if ( memcmp( v -> data + i * v -> block_size, x, v -> block_size ) == 0 )
-            occurences ++;
-    return occurences;
+    handle_err(
+        low > high || high > v -> size,
+        "Error viewing the vector! range out of bounds, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    close_gap(v);
+    return (VecView){ v -> data + low * v -> block_size, high - low, v -> block_size };
 }
 
-static inline u64 binary_search(Vector v, void* x, bool* found, int (*cmp)(void*, void*)){
-    u64 left = 0;
-    u64 right = v -> size - 1;
-    u64 mid;
-    int compare_output;
-    while(left < right){
-       mid = (left + right) / 2;
-       compare_output = cmp(v -> data + mid * v -> block_size, x);
-       if ( compare_output == 0 ){
-           *found = true;
-           return mid;
-        }
-       if ( compare_output < 0  )
-           left = mid + 1;
-       else
-           right = mid - 1;
-    }
-    *found = false;
-    return mid;
+VecView vec_view_sub(const VecView v, u64 low, u64 high){
+    handle_err(
+        low > high || high > v.size,
+        "Error viewing the view! range out of bounds, aborting now ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    return (VecView){ v.data + low * v.block_size, high - low, v.block_size };
 }
 
-static inline u64 normal_search(Vector v, void* x, bool* found, int (*cmp)(void*, void*)){
-    u64 i;
-    for(i = 0; i < v -> size; i++){
-        if ( cmp(v -> data + i * v -> block_size, x) == 0 ){
-            *found = true;
-            return i;
-        }
-    }
-    *found = false;
-    return i;
+bool vec_view_in(const VecView v, void* x){
+    return scan_find(v, x, 0) < v.size;
 }
 
-u64 vec_search(const Vector v, void* x, bool* sorted_found, int (*cmp)(void*, void*)){
+u64 vec_view_count(const VecView v, void* x){
+    return scan_count(v, x);
+}
+
+u64 vec_view_search(const VecView v, void* x, bool* sorted_found, int (*cmp)(void*, void*)){
     if ( *sorted_found == SORTED )
         return binary_search(v, x, sorted_found, cmp);
     return normal_search(v, x, sorted_found, cmp);
 }
 
-void vec_map_(const Vector input, Vector output, void* (*mapper)(void*), u8 input_size, u8 output_size){ 
-    handle_err(
-        input == NULL || output == NULL || input -> data == NULL || output -> data == NULL,
-        "Error in map method ! a null vector was passed, aborting now ...",
-        cleanup();
-        exit(EXIT_FAILURE);
-    )
+bool vec_view_eq(const VecView va, const VecView vb){
     handle_err(
-        input -> block_size != input_size || output -> block_size != output_size,
-        "unresolvable difference in datatypes of input, output and function of map ! aboring ...",
+        va.block_size != vb.block_size,
+        "unresolvable difference in datatypes of the compared views ! aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
+    return view_equal(va, vb);
+}
 
-    output -> size = 0;
-    if ( output -> capacity < input -> size){
-        const u64 old_capa = output -> capacity;
-        output -> capacity = input -> size;
-        output -> data = output -> arena == NULL? 
-            ds_realloc(output -> data, output -> capacity * output -> block_size):
-            realloc_on_arena(output -> arena, output -> data, old_capa * output -> block_size, output -> capacity * output -> block_size);
-    }
-    for(u64 i = 0; i < input -> size; i++)
-        memcpy(
-            output -> data + i * output -> block_size,
-            mapper(input -> data + i * input -> block_size),
-            output -> block_size
-        );
+void vec_view_print(const VecView v, void(*printer)(void*)){
+    print_view(v, printer);
 }
 
-static inline void swap(u8* a, u8* b, const u8 block_size){
-    u8 tmp[block_size];
-    memcpy(tmp, a, block_size);
-    memcpy(a, b, block_size);
-    memcpy(b, tmp, block_size);
+void vec_view_map_(const VecView input, Vector output, void* (*mapper)(void*), u32 input_size, u32 output_size){
+    map_view(input, output, mapper, input_size, output_size);
 }
 
-static inline i64 partition(u8* arr, const i64 low, const i64 high, const u8 block_size, int (*cmp)(void*, void*)){
-    u8 pivot[block_size];
-    memcpy(pivot, arr + high * block_size, block_size);
+// serialization: a header followed by chunks of at most VEC_CHUNK_BYTES of
+// elements, each one preceded by its element count and crc32c, a chunk of 0
+// elements ends the stream. integers are stored in the host byte order
+#define VEC_STREAM_MAGIC    0x014d525453434556ULL  // "VECSTRM\1"
+#define VEC_STREAM_VERSION  1
+#define VEC_CHUNK_BYTES     (1 << 20)
+#define VEC_IOV_CHUNKS      16              // chunks gathered by a single writev
 
-    i64 i = low - 1;
-    for (i64 j = low; j < high; j++) {
-        if (cmp(arr + j * block_size, pivot) < 0) {
-            i++;
-            swap(arr + i * block_size, arr + j * block_size, block_size);
+typedef struct{
+    u64     magic       ;
+    u32     version     ;
+    u32     block_size  ;
+    u64     size        ;
+    u32     pad         ;
+    u32     crc         ;                   // of the fields above
+} StreamHeader;
+
+typedef struct{
+    u64     count       ;
+    u32     crc         ;
+    u32     pad         ;
+} ChunkHeader;
+
+static u32 crc_table[256];
+
+static u32 crc32c_scalar(u32 crc, const u8* p, u64 n){
+    while ( n-- )
+        crc = crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+
+// sse4.2 has crc32c in hardware, 8 bytes per instruction
+__attribute__((target("sse4.2"))) static u32 crc32c_sse42(u32 crc, const u8* p, u64 n){
+    u64 c = crc;
+    for(; n >= 8; p += 8, n -= 8){
+        u64 w;
+        memcpy(&w, p, 8);
+        c = _mm_crc32_u64(c, w);
+    }
+    crc = (u32)c;
+    while ( n-- )
+        crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+#endif
+
+static u32 (*crc32c_update)(u32, const u8*, u64) = crc32c_scalar;
+
+__attribute__((constructor)) static void crc_dispatch(void){
+    for(u32 i = 0; i < 256; i++){
+        u32 c = i;
+        for(int k = 0; k < 8; k++)
+            c = c & 1 ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+        crc_table[i] = c;
+    }
+#if defined(__x86_64__) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports("sse4.2") )
+        crc32c_update = crc32c_sse42;
+#endif
+}
+
+static inline u32 crc32c(const void* p, u64 n){
+    return ~crc32c_update(~0u, (const u8*)p, n);
+}
+
+// both loop until every iovec went through, short transfers are resumed
+// in the middle of an iovec. false on errors and, for reads, on end of file
+static bool write_all(int fd, struct iovec* iov, int count){
+    for(;;){
+        while ( count > 0 && iov -> iov_len == 0 ){ iov++; count--; }
+        if ( count == 0 )
+            return true;
+        ssize_t n = writev(fd, iov, count);
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n <= 0 )
+            return false;
+        for(; count > 0 && (size_t)n >= iov -> iov_len; iov++, count--)
+            n -= iov -> iov_len;
+        if ( count > 0 ){
+            iov -> iov_base = (u8*)iov -> iov_base + n;
+            iov -> iov_len -= n;
         }
     }
-    swap(arr + (i+1) * block_size, arr + high * block_size, block_size);
-    return i+1;
 }
 
-static void quick_sort(u8* arr, const i64 low, const i64 high, const u8 block_size, int (*cmp)(void*, void*)){
-    if ( low < high ){
-        const int64_t pi = partition(arr, low, high, block_size, cmp);
+static bool read_all(int fd, struct iovec* iov, int count){
+    for(;;){
+        while ( count > 0 && iov -> iov_len == 0 ){ iov++; count--; }
+        if ( count == 0 )
+            return true;
+        ssize_t n = readv(fd, iov, count);
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n <= 0 )
+            return false;
+        for(; count > 0 && (size_t)n >= iov -> iov_len; iov++, count--)
+            n -= iov -> iov_len;
+        if ( count > 0 ){
+            iov -> iov_base = (u8*)iov -> iov_base + n;
+            iov -> iov_len -= n;
+        }
+    }
+}
 
-        quick_sort(arr, low, pi - 1, block_size, cmp);
-        quick_sort(arr, pi + 1, high, block_size, cmp);
+#ifdef __linux__
+// file backed vectors go from the page cache to fd without a user space copy,
+// returns how many bytes made it, the caller writes the rest itself
+static u64 send_all(int out, int in, off_t offset, u64 bytes){
+    u64 sent = 0;
+    while ( sent < bytes ){
+        ssize_t n = sendfile(out, in, &offset, bytes - sent);
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n <= 0 )
+            break;
+        sent += n;
     }
+    return sent;
 }
+#endif
 
-// Public sorting function
-void vec_sort(const Vector input, Vector output, int (*cmp)(void*, void*)) {
+static inline u64 chunk_len(const u32 block_size){
+    return block_size >= VEC_CHUNK_BYTES ? 1 : VEC_CHUNK_BYTES / block_size;
+}
+
+void vec_write(const Vector v, int fd){
+    close_gap(v);
+    const u32 bs  = v -> block_size;
+    const u64 per = chunk_len(bs);
+    StreamHeader head = { VEC_STREAM_MAGIC, VEC_STREAM_VERSION, bs, v -> size, 0, 0 };
+    head.crc = crc32c(&head, offsetof(StreamHeader, crc));
+
+    ChunkHeader  chunks[VEC_IOV_CHUNKS + 1];
+    struct iovec iov[2 * VEC_IOV_CHUNKS + 2];
+    int n = 0, c = 0;
+    iov[n++] = (struct iovec){ &head, sizeof(head) };
+#ifdef __linux__
+    bool zero_copy = v -> fd >= 0;
+#endif
+    for(u64 i = 0; i < v -> size; ){
+        const u64 count = v -> size - i < per ? v -> size - i : per;
+        u8* src = v -> data + i * bs;
+        chunks[c] = (ChunkHeader){ count, crc32c(src, count * bs), 0 };
+        iov[n++] = (struct iovec){ &chunks[c++], sizeof(ChunkHeader) };
+        i += count;
+#ifdef __linux__
+        if ( zero_copy ){
+            handle_err(
+                !write_all(fd, iov, n),
+                "Error writing the Vector! Watch out the stream is incomplete ...",
+                cleanup();
+                exit(EXIT_FAILURE);
+            )
+            n = c = 0;
+            const u64 sent = send_all(fd, v -> fd, (off_t)(src - v -> base), count * bs);
+            if ( sent == count * bs )
+                continue;
+            zero_copy = false;
+            src += sent;
+            iov[n++] = (struct iovec){ src, count * bs - sent };
+            continue;
+        }
+#endif
+        iov[n++] = (struct iovec){ src, count * bs };
+        if ( c == VEC_IOV_CHUNKS ){
+            handle_err(
+                !write_all(fd, iov, n),
+                "Error writing the Vector! Watch out the stream is incomplete ...",
+                cleanup();
+                exit(EXIT_FAILURE);
+            )
+            n = c = 0;
+        }
+    }
+    chunks[c] = (ChunkHeader){ 0, 0, 0 };
+    iov[n++] = (struct iovec){ &chunks[c], sizeof(ChunkHeader) };
     handle_err(
-        input == NULL || output == NULL || input -> data == NULL || output -> data == NULL,
-        "Error in map method ! a null vector was passed, aborting now ...",
+        !write_all(fd, iov, n),
+        "Error writing the Vector! Watch out the stream is incomplete ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
+}
+
+static StreamHeader read_stream_header(int fd){
+    StreamHeader head;
     handle_err(
-        input -> block_size != output -> block_size,
-        "unresolvable difference in datatypes of input, output of sort ! aboring ...",
+        !read_all(fd, &(struct iovec){ &head, sizeof(head) }, 1),
+        "Error reading the Vector stream header! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-
-    output -> size = input -> size;
-    if ( output -> capacity < input -> size ){
-        const u64 old_capa = output -> capacity;
-        output -> capacity = input -> size;
-        output -> data = output -> arena == NULL ?
-            ds_realloc(output -> data, output -> capacity * output -> block_size):
-            realloc_on_arena( output -> arena, output -> data, old_capa * output -> block_size, output -> capacity * output -> block_size ); 
-    }
-    if ( input -> size <= 1 )
-    {
-        memcpy(input -> data, output -> data, input -> block_size * input -> size);
-        return;
-    }
-    memcpy(output -> data, input -> data, input -> block_size * input -> size);
-    quick_sort(output -> data, 0, input -> size - 1, input -> block_size, cmp);
-}
-
-void vec_slice(const Vector input, Vector output, const u64 low, const u64 high){
     handle_err(
-        input == NULL || output == NULL || input -> data == NULL || output -> data == NULL,
-        "Error in slice method ! a null vector was passed, aborting now ...",
+        head.magic != VEC_STREAM_MAGIC || head.version != VEC_STREAM_VERSION ||
+        head.block_size == 0 || head.crc != crc32c(&head, offsetof(StreamHeader, crc)),
+        "Error the stream does not hold a Vector! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
     handle_err(
-        input -> block_size != output -> block_size,
-        "unresolvable difference in datatypes of input, output of slice ! aboring ...",
+        head.size > UINT64_MAX / head.block_size,
+        "Error the Vector stream is corrupted! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-
-    u64 len = high - low;
-    if ( output -> capacity < len){
-        const u64 old_capa = output -> capacity;
-        output -> capacity = len;
-        output -> data = output -> arena == NULL ? 
-            ds_realloc(output -> data, len * output -> block_size):
-            realloc_on_arena(output -> arena, output -> data, old_capa * output -> block_size, len * output -> block_size);
-    }
-    output -> size = len;
-    memcpy(output -> data, input -> data + low * input -> block_size, input -> block_size * len);
-}
-
-void vec_fit(Vector v){
-    const u64 old_capa = v -> capacity;
-    v -> capacity = v -> size;
-    v -> data = v -> arena == NULL ? 
-        ds_realloc(v -> data, v -> block_size * v -> capacity):
-        realloc_on_arena(v -> arena, v -> data, old_capa * v -> block_size, v -> block_size * v -> capacity); 
-}
-
-void vec_setcapacity(Vector v, u64 capa){
-    if ( capa < v -> size)
-        return;
-    const u64 old_capa = v -> capacity;
-    v -> capacity = capa;
-    v -> data = v -> arena == NULL ?
-        ds_realloc(v -> data, capa * v -> block_size):
-        realloc_on_arena(v -> arena, v -> data, old_capa * v -> block_size, capa * v -> block_size);
+    return head;
 }
 
-u64 vec_capacity(const Vector v){
+// every chunk is read straight into the spare capacity together with the
+// header of the next one, one readv per chunk and no intermediate buffer.
+// the size in the header is only checked against, the vector grows a chunk
+// at a time as the chunks pass their checks
+static u64 read_stream(Vector v, int fd, const StreamHeader head){
+    const u32 bs  = v -> block_size;
+    const u64 per = chunk_len(bs);
+    ChunkHeader chunk;
     handle_err(
-        v == NULL || v -> data == NULL,
-        "Error getting capacity for the null Vector! Aborting ...",
+        !read_all(fd, &(struct iovec){ &chunk, sizeof(chunk) }, 1),
+        "Error reading the Vector stream! Aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    return v -> capacity;
+    u64 got = 0;
+    while ( chunk.count != 0 ){
+        handle_err(
+            chunk.count > per || chunk.count > head.size - got,
+            "Error the Vector stream is corrupted! Aborting ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        const ChunkHeader cur = chunk;
+        reserve_for(v, v -> size + cur.count);
+        u8* dst = v -> data + v -> size * bs;
+        struct iovec iov[2] = {
+            { dst, cur.count * bs },
+            { &chunk, sizeof(chunk) }
+        };
+        handle_err(
+            !read_all(fd, iov, 2),
+            "Error reading the Vector stream! Aborting ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        handle_err(
+            crc32c(dst, cur.count * bs) != cur.crc,
+            "Error checksum mismatch in the Vector stream! Aborting ...",
+            cleanup();
+            exit(EXIT_FAILURE);
+        )
+        v -> size += cur.count;
+        index_stale(v);
+        got += cur.count;
+    }
+    handle_err(
+        got != head.size,
+        "Error the Vector stream is truncated! Aborting ...",
+        cleanup();
+        exit(EXIT_FAILURE);
+    )
+    index_settle(v);
+    return got;
+}
+
+Vector vec_read(int fd, Arena arena){
+    const StreamHeader head = read_stream_header(fd);
+    Vector v = arena == NULL ?
+        vec_init_(0, head.block_size):
+        vec_arena_(0, head.block_size, arena);
+    read_stream(v, fd, head);
+    return v;
 }
 
-u8 vec_blocksize(const Vector v){
+u64 vec_read_into(Vector v, int fd){
+    const StreamHeader head = read_stream_header(fd);
     handle_err(
-        v == NULL || v -> data == NULL,
-        "Error getting datasize for the null Vector! Aborting ...",
+        head.block_size != v -> block_size,
+        "unresolvable difference in datatypes of the Vector and the stream ! aborting ...",
         cleanup();
         exit(EXIT_FAILURE);
     )
-    return v -> block_size;
+    return read_stream(v, fd, head);
 }
@@ -3,11 +3,34 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <arena.h>                // personal arena lib
 
 #define UNSORTED    0
 #define SORTED      1
 
+// growth policies, what the capacity becomes once it is exhausted
+#define VEC_GROW_DOUBLE     0           // capacity * 2 (default)
+#define VEC_GROW_HALF       1           // capacity * 1.5
+#define VEC_GROW_LINEAR     2           // capacity + step
+#define VEC_GROW_CUSTOM     3           // set through vec_set_growth_fn
+
+// how vec_open_mapped opens its file
+#define VEC_MAP_RDONLY      0           // shared read only, the file must exist
+#define VEC_MAP_RDWR        1           // read write, the file is created if missing
+
+#define VEC_GAP_CLOSED      UINT64_MAX
+
+#define UNSIGNED_KEY 0
+#define SIGNED_KEY   1
+
+// how a PackedVector stores its integers, all of them in blocks of
+// VEC_PACK_BLOCK values bit packed at the width of the widest one
+#define VEC_PACK_FOR        0           // frame of reference, offsets from the block minimum
+#define VEC_PACK_DELTA      1           // non decreasing values, gaps from the previous one
+#define VEC_PACK_BITS       2           // 0 or 1, one bit per element
+#define VEC_PACK_BLOCK      128
+
 
 typedef uint64_t u64;
 typedef int64_t  i64;
@@ -15,9 +38,112 @@ typedef uint32_t u32;
 typedef uint8_t  u8;
 
 typedef struct vector* Vector;
+typedef struct vec_pool* VecPool;
+typedef struct vec_concurrent* ConcurrentVector;
+typedef struct vec_packed* PackedVector;
 
-Vector vec_init_(u64 def, u8 block_size);
-Vector vec_arena_(u64 def, u8 block_size, Arena arena);
+// a borrowed, read only window over a vector's elements, it owns nothing and
+// stays valid only as long as the vector is not grown, shrunk or freed
+typedef struct{
+    const u8*   data        ;
+    u64         size        ;
+    u32         block_size  ;
+} VecView;
+
+// sequential decoder of a PackedVector, one block at a time
+typedef struct{
+    const struct vec_packed* p;
+    u64         next        ;       // index of the next element
+    u32         at          ;       // position of the next element in buf
+    u32         len         ;
+    u64         buf[VEC_PACK_BLOCK];
+} VecPackedIter;
+
+// what a vector did to memory since it was created, only counted when both the
+// library and its users are built with -DVEC_STATS, all zero otherwise
+typedef struct{
+    u64     grows           ;       // times the buffer had to get bigger
+    u64     realloc_bytes   ;       // bytes copied because the buffer moved
+    u64     moved_bytes     ;       // bytes shifted by insertions and removals
+    u64     peak_capacity   ;
+    u64     cmp_calls       ;       // comparator calls made by sorts and searches
+} VecStats;
+
+// what the vectors of a tracked arena (vec_arena_track) did with it
+typedef struct{
+    u64     live_bytes      ;       // held by vector buffers
+    u64     wasted_bytes    ;       // outgrown buffers waiting on the free lists
+    u64     recycled_bytes  ;       // taken back off the free lists so far
+    u64     extended        ;       // growths that extended a buffer in place
+} VecArenaStats;
+
+// the layout is public only so that the DEFINE_VEC generated functions can be
+// inlined, everything else should go through the vec_* functions
+struct vector{
+    u64     capacity    ;
+    u64     size        ;
+    u8*     data        ;
+    u8*     base        ;           // start of the allocation, differs from data when aligned
+    Arena   arena       ;
+    u32     block_size  ;
+    u32     align       ;           // 0 when the allocator's alignment is good enough
+    u8      growth      ;
+    u64     grow_step   ;
+    u64   (*grow)(u64 capacity, u64 needed);
+    u64     reserved    ;           // bytes mapped for mmap backed vectors, 0 otherwise
+    int     fd          ;           // backing file of mapped vectors, -1 otherwise
+    bool    readonly    ;
+    bool    gapped      ;           // spare capacity may sit in the middle (vec_gap_)
+    u64     gap         ;           // index the spare capacity starts at, VEC_GAP_CLOSED when at the end
+    struct vec_hash_index* index;   // vec_attach_hash_index, NULL otherwise
+    bool    inlined     ;           // data is the storage right after the header (vec_small_, VEC_LOCAL)
+    bool    local       ;           // VEC_LOCAL, what it spills is freed by vec_local_free, not at cleanup
+#ifdef VEC_STATS
+    VecStats        stats       ;
+    struct vector*  live_prev   ;           // registry of the live vectors
+    struct vector*  live_next   ;
+#endif
+};
+
+Vector vec_init_(u64 def, u32 block_size);
+Vector vec_arena_(u64 def, u32 block_size, Arena arena);
+// data is kept aligned to align (a power of two) bytes through every growth
+Vector vec_aligned_(u64 def, u32 block_size, u32 align, Arena arena);
+// backed by an anonymous mapping of reserve elements (linux), only touched
+// pages use memory and growing past it is an mremap, never a copy
+Vector vec_mmap_(u64 reserve, u32 block_size);
+// gap buffer: the spare capacity follows the last insertion or removal, so
+// edits near the previous one only shift the elements in between. operations
+// that need the elements contiguous close the gap first, raw access to data
+// has to go through vec_close_gap
+Vector vec_gap_(u64 def, u32 block_size, Arena arena);
+// the header and the first n elements in a single allocation (one malloc, or
+// one arena block), the elements move out to the heap or the arena only once
+// the vector outgrows them
+Vector vec_small_(u64 n, u32 block_size, Arena arena);
+// backs VEC_LOCAL, mem is a header of header_size bytes (the caller's
+// sizeof(struct vector), both sides must agree on VEC_STATS) followed by
+// VEC_INLINE_OFFSET aligned storage for n elements that the caller owns
+Vector vec_local_(void* mem, u64 header_size, u64 n, u32 block_size, Arena arena) __attribute__((nonnull(1)));
+// ends a VEC_LOCAL vector, the buffer it spilled to is freed (or handed back
+// to its tracked arena). a local that may have spilled must go through it
+// before its block ends, nothing else frees that buffer
+void   vec_local_free(Vector v) __attribute__((nonnull(1)));
+void   vec_close_gap(Vector v) __attribute__((nonnull(1)));
+// backed by the file at path (linux), the elements live in the file after a
+// small header and the vector picks up where the last process left it. pushes
+// grow the file, read only vectors share the page cache and must not be modified
+Vector vec_open_mapped(const char* path, u32 block_size, u8 mode) __attribute__((nonnull(1)));
+// writes the size back to the header and flushes the mapping to the file,
+// a no-op for vectors that are not file backed
+void   vec_sync(Vector v) __attribute__((nonnull(1)));
+// chunked and checksummed binary stream of the elements, readable back from
+// a file, a pipe or a socket. errors abort like everything else
+void   vec_write(const Vector v, int fd) __attribute__((nonnull(1)));
+Vector vec_read(int fd, Arena arena);
+// appends the elements of the next stream on fd, one chunk at a time,
+// returns how many were read
+u64    vec_read_into(Vector v, int fd) __attribute__((nonnull(1)));
 void   vec_push(Vector, void*) __attribute__((nonnull(1,2)));
 void   vec_pop_(Vector, void*) __attribute__((nonnull(1)));
 void   vec_get_(const Vector, u64 index, void* gottem)  __attribute__((nonnull(1, 3)));;
@@ -27,6 +153,36 @@ void   vec_remove_(Vector, u64, void* gottem) __attribute__((nonnull(1)));
 void   vec_dbg(const Vector) __attribute__((nonnull(1)));
 void   vec_print(Vector, void(*)(void*)) __attribute__((nonnull(1,2)));
 void   vec_sort(Vector in, Vector out, int (*cmp)(void*, void *)) __attribute__((nonnull(1,2,3)));
+void   vec_stable_sort(Vector in, Vector out, int (*cmp)(void*, void *)) __attribute__((nonnull(1,2,3)));
+// reorders v so that v[nth] is what sorting would put there, with nothing
+// greater before it and nothing smaller after it, in linear time on average
+void   vec_nth_element(Vector v, u64 nth, int (*cmp)(void*, void*)) __attribute__((nonnull(1,3)));
+// out receives the k smallest elements of in, sorted (all of them when k is
+// larger), in O(n log k). in and out may be the same vector
+void   vec_partial_sort(Vector in, Vector out, u64 k, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,4)));
+// streaming top k: heap keeps the k smallest elements pushed into it so far
+// as a max heap (its first element is the one the next better push evicts).
+// finish sorts them, after which the vector is no longer a heap
+void   vec_topk_push(Vector heap, void* x, u64 k, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,4)));
+void   vec_topk_finish(Vector heap, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2)));
+// on vectors sorted by cmp, linear (or better when one of the inputs is much
+// shorter). out is sized by the call and must not be one of the inputs,
+// duplicates are kept as many times as std::set_* would keep them
+void   vec_merge(const Vector a, const Vector b, Vector out, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3,4)));
+u64    vec_set_union(const Vector a, const Vector b, Vector out, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3,4)));
+u64    vec_set_intersection(const Vector a, const Vector b, Vector out, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3,4)));
+u64    vec_set_difference(const Vector a, const Vector b, Vector out, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3,4)));
+// whether every element of b is in a (with its multiplicity)
+bool   vec_includes(const Vector a, const Vector b, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3)));
+// sorts batch in place then merges it into the sorted v, the elements of v
+// only move once, to make room at the tail
+void   vec_insert_sorted_batch(Vector v, Vector batch, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3)));
+// sorts on nthreads threads (0 means one per online cpu), small vectors are
+// sorted serially, the result only depends on the input and nthreads
+void   vec_sort_parallel(Vector in, Vector out, int (*cmp)(void*, void *), u32 nthreads) __attribute__((nonnull(1,2,3)));
+// stable LSD radix sort on an integer key of key_width (1 to 8) bytes found at
+// key_offset inside each element, signedness is SIGNED_KEY or UNSIGNED_KEY
+void   vec_radix_sort(Vector in, Vector out, u64 key_offset, u8 key_width, bool signedness) __attribute__((nonnull(1,2)));
 void   vec_reverse(Vector in, Vector out) __attribute__((nonnull(1,2)));
 void   vec_join(Vector, const Vector) __attribute__((nonnull(1,2)));
 bool   vec_empty(const Vector) __attribute__((nonnull(1)));
@@ -35,23 +191,187 @@ bool   vec_eq(const Vector, const Vector) __attribute__((nonnull(1,2)));
 u64    vec_len(const Vector) __attribute__((nonnull(1)));
 void   vec_copy(const Vector src, Vector dest) __attribute__((nonnull(1,2)));
 u64    vec_count(const Vector, void*) __attribute__((nonnull(1,2)));
+// index of the first element equal to x, vec_len(v) when there is none
+u64    vec_find_first(const Vector v, void* x) __attribute__((nonnull(1,2)));
+// fills indices (a vector of u64) with every index holding x, returns how many
+u64    vec_find_all(const Vector v, void* x, Vector indices) __attribute__((nonnull(1,2,3)));
+// hashes the elements into an open addressing table kept up to date by the
+// vector's own operations, vec_in and vec_count then stop scanning. hash may
+// be NULL for a built in one, attaching again rebuilds the table. writes
+// made straight through data are not seen, attach again after them. bulk
+// operations rebuild it before returning, lookups never write to it
+void   vec_attach_hash_index(Vector v, u64 (*hash)(const void* x, u32 size)) __attribute__((nonnull(1)));
+// index of one of the copies of x (not necessarily the first), len if absent
+u64    vec_hash_find(const Vector v, void* x) __attribute__((nonnull(1,2)));
 void   vec_clear(const Vector) __attribute__((nonnull(1)));
+// on sorted vectors: index of the first element >= x (lower) or > x (upper)
+u64    vec_lower_bound(const Vector, void* x, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3)));
+u64    vec_upper_bound(const Vector, void* x, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3)));
+void   vec_equal_range(const Vector, void* x, int (*cmp)(void*, void*), u64* low, u64* high) __attribute__((nonnull(1,2,3,4,5)));
+// copies a sorted vector into index in breadth first (eytzinger) order, lookups
+// through vec_index_lower_bound then touch far fewer cache lines, the returned
+// position indexes the index vector (vec_len(index) when every element is < x)
+void   vec_build_search_index(const Vector sorted, Vector index) __attribute__((nonnull(1,2)));
+u64    vec_index_lower_bound(const Vector index, void* x, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3)));
 u64    vec_search(const Vector, void* x, bool* sorted_found, int (*cmp)(void*, void*)) __attribute__((nonnull(1,2,3,4)));
 void   vec_slice(const Vector, Vector, const u64 low, const u64 high) __attribute__((nonnull(1,2)));
 // the third argument is a pointer to a boolean value (sorted or unsorted)
 // since if the vector is already sorted searching can be optimized 
 // after the search if the element is found or not is written to that same 
-// variable
+// variable, on a sorted vector the first match (or the insertion point) is returned
 void  vec_map_(const Vector input, Vector output, void* (*mapper)(void*),
-        u8 input_size, u8 output_size) __attribute__((nonnull(1,2,3)));
+        u32 input_size, u32 output_size) __attribute__((nonnull(1,2,3)));
+// views: the elements [low, high) of v, no allocation and no copy
+VecView vec_view(const Vector v, u64 low, u64 high) __attribute__((nonnull(1)));
+VecView vec_view_sub(const VecView v, u64 low, u64 high);
+bool    vec_view_in(const VecView v, void* x) __attribute__((nonnull(2)));
+u64     vec_view_count(const VecView v, void* x) __attribute__((nonnull(2)));
+u64     vec_view_search(const VecView v, void* x, bool* sorted_found, int (*cmp)(void*, void*)) __attribute__((nonnull(2,3,4)));
+bool    vec_view_eq(const VecView va, const VecView vb);
+void    vec_view_print(const VecView v, void(*printer)(void*)) __attribute__((nonnull(2)));
+void    vec_view_map_(const VecView input, Vector output, void* (*mapper)(void*),
+        u32 input_size, u32 output_size) __attribute__((nonnull(2,3)));
+// batched transforms: kernel gets contiguous runs of count input elements and
+// writes count output elements, in place when both vectors are the same
+void  vec_map_batch(const Vector input, Vector output,
+        void (*kernel)(const void* in, void* out, u64 count)) __attribute__((nonnull(1,2,3)));
+void  vec_map_inplace(Vector v, void (*kernel)(const void* in, void* out, u64 count)) __attribute__((nonnull(1,2)));
+// keeps the elements pred accepts, output may be input, returns the new length
+u64   vec_filter(const Vector input, Vector output,
+        bool (*pred)(const void* x, void* ctx), void* ctx) __attribute__((nonnull(1,2,3)));
+// acc is owned by the caller, fold steps one element at a time and reduce
+// hands out contiguous batches
+void  vec_fold(const Vector v, void* acc, void (*step)(void* acc, const void* x)) __attribute__((nonnull(1,3)));
+void  vec_reduce(const Vector v, void* acc, void (*kernel)(void* acc, const void* xs, u64 count)) __attribute__((nonnull(1,3)));
+// a pool of worker threads created once and reused by the vec_pool_* calls,
+// 0 threads means one per online cpu, the calling thread counts as one
+VecPool vec_pool_create(u32 nthreads);
+void    vec_pool_destroy(VecPool pool) __attribute__((nonnull(1)));
+u32     vec_pool_size(const VecPool pool) __attribute__((nonnull(1)));
+// same contracts as vec_map_batch / vec_filter / vec_reduce, chunks of the
+// vector run concurrently so kernel and pred must not share mutable state,
+// filter keeps the input order
+void    vec_pool_map(VecPool pool, const Vector input, Vector output,
+        void (*kernel)(const void* in, void* out, u64 count)) __attribute__((nonnull(1,2,3,4)));
+u64     vec_pool_filter(VecPool pool, const Vector input, Vector output,
+        bool (*pred)(const void* x, void* ctx), void* ctx) __attribute__((nonnull(1,2,3,4)));
+// every chunk is reduced into its own copy of identity (acc_size bytes), the
+// partial results are then folded into acc with the associative combine
+void    vec_pool_reduce(VecPool pool, const Vector v, void* acc, const void* identity, u64 acc_size,
+        void (*kernel)(void* acc, const void* xs, u64 count),
+        void (*combine)(void* acc, const void* other)) __attribute__((nonnull(1,2,3,4,6,7)));
+// append only vector safe for any number of concurrent pushers and readers,
+// elements live in buckets that are never moved so their addresses stay valid
+// until vec_concurrent_destroy. readers see the elements below len, all of
+// them completely written
+ConcurrentVector vec_concurrent_create(u32 block_size);
+void    vec_concurrent_destroy(ConcurrentVector cv) __attribute__((nonnull(1)));
+// returns the index the element landed at
+u64     vec_concurrent_push(ConcurrentVector cv, const void* x) __attribute__((nonnull(1,2)));
+u64     vec_concurrent_len(const ConcurrentVector cv) __attribute__((nonnull(1)));
+void*   vec_concurrent_at(const ConcurrentVector cv, u64 index) __attribute__((nonnull(1)));
+void    vec_concurrent_get(const ConcurrentVector cv, u64 index, void* gottem) __attribute__((nonnull(1,3)));
+// copies the elements below len into out
+void    vec_concurrent_collect(const ConcurrentVector cv, Vector out) __attribute__((nonnull(1,2)));
+// compressed vector of u64, see VEC_PACK_*. the last block fills up as plain
+// values before it is packed. get on a delta vector decodes a whole block,
+// walk it with the iterator. search returns the first index holding x, len
+// when there is none
+PackedVector vec_packed_create(u8 mode);
+void    vec_packed_destroy(PackedVector p) __attribute__((nonnull(1)));
+void    vec_packed_push(PackedVector p, u64 x) __attribute__((nonnull(1)));
+u64     vec_packed_get(const PackedVector p, u64 index) __attribute__((nonnull(1)));
+u64     vec_packed_len(const PackedVector p) __attribute__((nonnull(1)));
+u64     vec_packed_bytes(const PackedVector p) __attribute__((nonnull(1)));
+u64     vec_packed_search(const PackedVector p, u64 x) __attribute__((nonnull(1)));
+void    vec_packed_iter(const PackedVector p, VecPackedIter* it) __attribute__((nonnull(1,2)));
+bool    vec_packed_next(VecPackedIter* it, u64* x) __attribute__((nonnull(1,2)));
+// v and out hold unsigned integers of 1, 2, 4 or 8 bytes, unpack replaces
+// the elements of out
+PackedVector vec_pack(const Vector v, u8 mode) __attribute__((nonnull(1)));
+void    vec_unpack(const PackedVector p, Vector out) __attribute__((nonnull(1,2)));
+// mmap backed vectors keep their capacity and give the unused pages back instead
 void  vec_fit(Vector v) __attribute__((nonnull(1)));
+void  vec_set_growth(Vector v, u8 policy, u64 step) __attribute__((nonnull(1)));
+// grow returns the new capacity, anything smaller than needed is bumped up
+void  vec_set_growth_fn(Vector v, u64 (*grow)(u64 capacity, u64 needed)) __attribute__((nonnull(1,2)));
 void  vec_setcapacity(Vector v, u64 capa) __attribute__((nonnull(1)));
 u64   vec_capacity(const Vector v) __attribute__((nonnull(1)));
-u8    vec_blocksize(const Vector v) __attribute__((nonnull(1)));
+u32   vec_blocksize(const Vector v) __attribute__((nonnull(1)));
+// grows the capacity to at least n elements (never shrinks)
+void  vec_reserve(Vector v, u64 n) __attribute__((nonnull(1)));
+// reports the error and aborts, used by the inlined typed functions
+void  vec_fail_(const char* msg) __attribute__((noreturn, cold, nonnull(1)));
+// the typed functions rewrote the elements, the hash index is rebuilt right away
+void  vec_index_rebuild_(Vector v) __attribute__((nonnull(1)));
+void  vec_stats(const Vector v, VecStats* stats) __attribute__((nonnull(1,2)));
+// growth on an arena always extends a buffer in place when it is the latest
+// allocation. once an arena is tracked, the buffers vectors outgrow there go
+// on size class free lists that later growths draw from. track it before
+// its first vector, and forget it before it is reset or destroyed since
+// the lists live inside it. arena vectors never shrink (vec_fit keeps them)
+void  vec_arena_track(Arena a) __attribute__((nonnull(1)));
+void  vec_arena_forget(Arena a) __attribute__((nonnull(1)));
+void  vec_arena_stats(const Arena a, VecArenaStats* stats) __attribute__((nonnull(1,2)));
+// prints the stats of every live vector to stderr. arena vectors die with
+// their arena behind the registry's back, vec_stats_forget them beforehand
+void  vec_stats_dump(void);
+void  vec_stats_forget(Vector v) __attribute__((nonnull(1)));
+// range operations, the buffer is grown at most once and the tail is shifted
+// at most once per call whatever the number of elements. the source may point
+// into v itself
+void  vec_push_n(Vector v, void* x, u64 n) __attribute__((nonnull(1,2)));
+void  vec_extend_from(Vector v, const void* arr, u64 count) __attribute__((nonnull(1,2)));
+void  vec_insert_range(Vector v, const void* arr, u64 count, u64 index) __attribute__((nonnull(1,2)));
+// gottem may be NULL, otherwise it receives the (high - low) removed elements
+void  vec_erase_range(Vector v, u64 low, u64 high, void* gottem) __attribute__((nonnull(1)));
+// single pass compaction, each returns how many elements went away. removed
+// may be NULL, otherwise it ends up holding them in their original order.
+// fit trims the capacity afterwards (vec_fit)
+u64   vec_remove_if(Vector v, bool (*pred)(const void* x, void* ctx), void* ctx, Vector removed, bool fit) __attribute__((nonnull(1,2)));
+u64   vec_remove_value(Vector v, void* x, Vector removed, bool fit) __attribute__((nonnull(1,2)));
+// drops the elements equal (cmp == 0) to the one before them
+u64   vec_unique(Vector v, int (*cmp)(void*, void*), Vector removed, bool fit) __attribute__((nonnull(1,2)));
+// same as vec_unique on a sorted v, faster on long runs of duplicates
+u64   vec_dedup_sorted(Vector v, int (*cmp)(void*, void*), Vector removed, bool fit) __attribute__((nonnull(1,2)));
 
 #define vec_init(T, n, a)                                                             \
     a == NULL ? vec_init_(n, sizeof(T)) : vec_arena_(n, sizeof(T), a);                \
 
+#define vec_init_aligned(T, n, align, a)                                             \
+    vec_aligned_(n, sizeof(T), align, a)
+
+#define vec_init_mmap(T, reserve)                                                     \
+    vec_mmap_(reserve, sizeof(T))
+
+#define vec_init_gap(T, n, a)                                                         \
+    vec_gap_(n, sizeof(T), a)
+
+#define vec_init_small(T, n, a)                                                       \
+    vec_small_(n, sizeof(T), a)
+
+// where the inline elements start after the header
+#define VEC_INLINE_OFFSET   ((sizeof(struct vector) + 15) & ~(size_t)15)
+
+// a vector living in the enclosing block with room for n elements on the
+// stack, it spills to the heap (or to the arena a) only when it outgrows them.
+// it dies with the block, it must not be returned, is not in the VEC_STATS
+// registry and has to be ended with vec_local_free once it may have spilled
+#define VEC_LOCAL(T, n, a)                                                            \
+    vec_local_(&(struct {                                                             \
+        struct vector h;                                                              \
+        _Alignas(16) u8 buf[(n) * sizeof(T)];                                         \
+    }){ .h.size = 0 }.h, sizeof(struct vector), (n), sizeof(T), (a))
+
+// where element i actually sits, past the gap of a gap buffer the spare
+// capacity has to be skipped
+static inline u64 vec_slot_(const Vector v, u64 i){
+    return i + (i >= v -> gap) * (v -> capacity - v -> size);
+}
+
+#define vec_init_concurrent(T)                                                        \
+    vec_concurrent_create(sizeof(T))
+
 #define DEFINE_VECPRINT(T)                                                            \
     void vec_print_##T(const Vector v, void(*printer)(T)){                            \
         const void tmp(void* x){                                                      \
@@ -60,6 +380,145 @@ u8    vec_blocksize(const Vector v) __attribute__((nonnull(1)));
         vec_print((v), (tmp));                                                        \
     }
 
+// generates statically typed functions over the same struct vector:
+//     vec_T_init, vec_T_data, vec_T_at, vec_T_push, vec_T_get, vec_T_set, vec_T_pop,
+//     vec_T_sort
+// elements are passed by value and accessed through a T* so that every access
+// compiles to a plain load / store, T must be a single identifier (typedef it)
+// and the vector must have been created with block_size == sizeof(T)
+#define DEFINE_VEC(T)                                                                 \
+    static inline Vector vec_##T##_init(u64 n, Arena a){                              \
+        return a == NULL ? vec_init_(n, sizeof(T)) : vec_arena_(n, sizeof(T), a);     \
+    }                                                                                 \
+    static inline T* vec_##T##_data(const Vector v){                                  \
+        vec_close_gap(v);                                                             \
+        return (T*)v -> data;                                                         \
+    }                                                                                 \
+    static inline T* vec_##T##_at(const Vector v, u64 i){                             \
+        return (T*)v -> data + vec_slot_(v, i);                                       \
+    }                                                                                 \
+    /* attached indexes and read only mappings go through the checked path */         \
+    static inline void vec_##T##_push(Vector v, T x){                                 \
+        if ( __builtin_expect(v -> index != NULL || v -> readonly, 0) ){              \
+            vec_push(v, &x);                                                          \
+            return;                                                                   \
+        }                                                                             \
+        if ( __builtin_expect(v -> gap != VEC_GAP_CLOSED, 0) )                        \
+            vec_close_gap(v);                                                         \
+        if ( __builtin_expect(v -> size == v -> capacity, 0) )                        \
+            vec_reserve(v, v -> size + 1);                                            \
+        ((T*)v -> data)[v -> size++] = x;                                             \
+    }                                                                                 \
+    static inline T vec_##T##_get(const Vector v, u64 i){                             \
+        if ( __builtin_expect(i >= v -> size, 0) )                                    \
+            vec_fail_("Out Of Bounds Error ...");                                     \
+        return ((T*)v -> data)[vec_slot_(v, i)];                                      \
+    }                                                                                 \
+    static inline void vec_##T##_set(Vector v, u64 i, T x){                           \
+        if ( __builtin_expect(i >= v -> size, 0) )                                    \
+            vec_fail_("Error setting a case of the vector out of bounds! aborting now ...");\
+        if ( __builtin_expect(v -> index != NULL || v -> readonly, 0) )               \
+            vec_set(v, &x, i);                                                        \
+        else                                                                          \
+            ((T*)v -> data)[vec_slot_(v, i)] = x;                                     \
+    }                                                                                 \
+    static inline T vec_##T##_pop(Vector v){                                          \
+        if ( __builtin_expect(v -> size == 0, 0) )                                    \
+            vec_fail_("Illegal Popping operation on an empty vector ...");            \
+        if ( __builtin_expect(v -> index != NULL || v -> readonly, 0) ){              \
+            T x;                                                                      \
+            vec_pop_(v, &x);                                                          \
+            return x;                                                                 \
+        }                                                                             \
+        if ( __builtin_expect(v -> gap < v -> size, 0) )                              \
+            vec_close_gap(v);                                                         \
+        return ((T*)v -> data)[--v -> size];                                          \
+    }                                                                                 \
+    static inline void vec_##T##_isort_(T* a, u64 n, int (*cmp)(T, T)){               \
+        for(u64 i = 1; i < n; i++){                                                   \
+            T x = a[i];                                                               \
+            u64 j = i;                                                                \
+            for(; j > 0 && cmp(x, a[j - 1]) < 0; j--)                                 \
+                a[j] = a[j - 1];                                                      \
+            a[j] = x;                                                                 \
+        }                                                                             \
+    }                                                                                 \
+    static inline void vec_##T##_sift_(T* a, u64 root, u64 n, int (*cmp)(T, T)){      \
+        T x = a[root];                                                                \
+        for(u64 child; (child = 2 * root + 1) < n; root = child){                     \
+            if ( child + 1 < n && cmp(a[child], a[child + 1]) < 0 )                   \
+                child++;                                                              \
+            if ( cmp(x, a[child]) >= 0 )                                              \
+                break;                                                                \
+            a[root] = a[child];                                                       \
+        }                                                                             \
+        a[root] = x;                                                                  \
+    }                                                                                 \
+    static inline void vec_##T##_hsort_(T* a, u64 n, int (*cmp)(T, T)){               \
+        for(u64 i = n / 2; i-- > 0;)                                                  \
+            vec_##T##_sift_(a, i, n, cmp);                                            \
+        for(u64 i = n; i-- > 1;){                                                     \
+            T t = a[0]; a[0] = a[i]; a[i] = t;                                        \
+            vec_##T##_sift_(a, 0, i, cmp);                                            \
+        }                                                                             \
+    }                                                                                 \
+    /* median-of-3 hoare quicksort, loops on the smaller half and falls back */       \
+    /* to heapsort once the depth budget is spent                           */        \
+    static inline void vec_##T##_qsort_(T* a, u64 n, int (*cmp)(T, T)){               \
+        struct { T* a; u64 n; u32 depth; } stack[64];                                 \
+        u32 top = 0;                                                                  \
+        u32 depth = 2 * (64 - __builtin_clzll(n | 1));                                \
+        for(;;){                                                                      \
+            while ( n > 16 ){                                                         \
+                if ( depth-- == 0 ){                                                  \
+                    vec_##T##_hsort_(a, n, cmp);                                      \
+                    n = 0;                                                            \
+                    break;                                                            \
+                }                                                                     \
+                const u64 m = (n - 1) / 2;                                            \
+                T t;                                                                  \
+                if ( cmp(a[m], a[0]) < 0 ){ t = a[m]; a[m] = a[0]; a[0] = t; }        \
+                if ( cmp(a[n - 1], a[m]) < 0 ){                                       \
+                    t = a[n - 1]; a[n - 1] = a[m]; a[m] = t;                          \
+                    if ( cmp(a[m], a[0]) < 0 ){ t = a[m]; a[m] = a[0]; a[0] = t; }    \
+                }                                                                     \
+                const T pivot = a[m];                                                 \
+                u64 i = (u64)-1, j = n;                                               \
+                for(;;){                                                              \
+                    do i++; while ( cmp(a[i], pivot) < 0 );                           \
+                    do j--; while ( cmp(pivot, a[j]) < 0 );                           \
+                    if ( i >= j )                                                     \
+                        break;                                                        \
+                    t = a[i]; a[i] = a[j]; a[j] = t;                                  \
+                }                                                                     \
+                const u64 ln = j + 1;                                                 \
+                if ( ln < n - ln ){                                                   \
+                    stack[top].a = a + ln; stack[top].n = n - ln; stack[top++].depth = depth;\
+                    n = ln;                                                           \
+                } else {                                                              \
+                    stack[top].a = a; stack[top].n = ln; stack[top++].depth = depth;  \
+                    a += ln; n -= ln;                                                 \
+                }                                                                     \
+            }                                                                         \
+            vec_##T##_isort_(a, n, cmp);                                              \
+            if ( top == 0 )                                                           \
+                return;                                                               \
+            top--;                                                                    \
+            a = stack[top].a; n = stack[top].n; depth = stack[top].depth;             \
+        }                                                                             \
+    }                                                                                 \
+    static inline void vec_##T##_sort(const Vector in, Vector out, int (*cmp)(T, T)){ \
+        vec_close_gap(in);                                                            \
+        vec_reserve(out, in -> size);                                                 \
+        if ( in != out )                                                              \
+            memcpy(out -> data, in -> data, in -> size * sizeof(T));                  \
+        out -> size = in -> size;                                                     \
+        vec_##T##_qsort_((T*)out -> data, out -> size, cmp);                          \
+        if ( __builtin_expect(out -> index != NULL, 0) )                              \
+            vec_index_rebuild_(out);                                                  \
+    }
+
+
 #define vec_get(v, i, T)                                                              \
     ({                                                                                \
         T odfijoijqewofjoqwej;                                                        \
@@ -81,11 +540,22 @@ u8    vec_blocksize(const Vector v) __attribute__((nonnull(1)));
         f12983u4021jf2190uj;                                                          \
     })
 
+#define vec_extend(v, T, ...)                                                         \
+    do{                                                                               \
+        T args[] = { __VA_ARGS__ };                                                   \
+        vec_extend_from((v), args, sizeof(args) / sizeof(T));                         \
+    } while(0)
+
 #define vec_map(in, out, f, T, U)                                                     \
     do{                                                                               \
         vec_map_((in), (out), (f), sizeof(T), sizeof(U));                             \
     } while(0)
 
+#define vec_view_map(in, out, f, T, U)                                                \
+    do{                                                                               \
+        vec_view_map_((in), (out), (f), sizeof(T), sizeof(U));                        \
+    } while(0)
+
 /*
 #define vec(T, ...)                                                                   \
     ({                                                                                \
@@ -103,8 +573,7 @@ u8    vec_blocksize(const Vector v) __attribute__((nonnull(1)));
         T args[] = { __VA_ARGS__ };                                                   \
         u64 length = sizeof(args) / sizeof(T);                                        \
         Vector v = vec_init(T, length, a);                                            \
-        for(u64 i = 0; i < length; i++)                                               \
-            vec_push(v, args + i);                                                    \
+        vec_extend_from(v, args, length);                                             \
         v;                                                                            \
     })
 